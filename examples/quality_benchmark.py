@@ -0,0 +1,50 @@
+"""
+Benchmark: render speed per quality mode
+
+Renders the same notes at each `set_quality` setting and prints the real-time
+factor, the seconds of audio rendered per second of wall time. Pass a preset
+to measure something heavier than the init patch.
+
+    python quality_benchmark.py [--preset path/to/preset.vital]
+"""
+
+import argparse
+import time
+
+import vita
+
+SAMPLE_RATE = 44_100
+QUALITIES = ["draft", "normal", "high"]
+
+
+def real_time_factor(synth, notes, note_dur, render_dur, repeats):
+    synth.render_batch(notes, [0.7], [note_dur], render_dur)  # warm caches
+
+    start = time.perf_counter()
+    for _ in range(repeats):
+        synth.render_batch(notes, [0.7], [note_dur], render_dur)
+    elapsed = time.perf_counter() - start
+    return repeats * len(notes) * render_dur / elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--preset", help="Preset file to render instead of the init patch.")
+    parser.add_argument("--repeats", type=int, default=5)
+    args = parser.parse_args()
+
+    synth = vita.Synth()
+    synth.set_sample_rate(SAMPLE_RATE)
+    if args.preset and not synth.load_preset(args.preset):
+        raise SystemExit(f"Could not load {args.preset}")
+
+    notes = [48, 55, 60, 64, 67, 72]
+    print(f"{'quality':<8} {'real-time factor':>17}")
+    for quality in QUALITIES:
+        synth.set_quality(quality)
+        rtf = real_time_factor(synth, notes, 1.0, 2.0, args.repeats)
+        print(f"{quality:<8} {rtf:>16.1f}x")
+
+
+if __name__ == "__main__":
+    main()
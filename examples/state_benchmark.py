@@ -0,0 +1,51 @@
+"""
+Benchmark: pickled state against preset JSON
+
+Prints the size of a Synth's pickled state and of its preset JSON, and the best
+time to save and load each. Pass a preset to measure something heavier than
+the init patch.
+
+    python state_benchmark.py [--preset path/to/preset.vital]
+"""
+
+import argparse
+import pickle
+import time
+
+import vita
+
+
+def best_time(function, repeats):
+    best = float("inf")
+    for _ in range(repeats):
+        start = time.perf_counter()
+        function()
+        best = min(best, time.perf_counter() - start)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--preset", help="Preset file to measure instead of the init patch.")
+    parser.add_argument("--repeats", type=int, default=5)
+    args = parser.parse_args()
+
+    synth = vita.Synth()
+    if args.preset and not synth.load_preset(args.preset):
+        raise SystemExit(f"Could not load {args.preset}")
+
+    preset = synth.to_json()
+    pickled = pickle.dumps(synth)
+    print(f"{'':>8} {'bytes':>10} {'save ms':>9} {'load ms':>9}")
+
+    save = best_time(synth.to_json, args.repeats)
+    load = best_time(lambda: vita.Synth().load_json(preset), args.repeats)
+    print(f"{'json':>8} {len(preset.encode()):>10} {save * 1e3:>9.2f} {load * 1e3:>9.2f}")
+
+    save = best_time(lambda: pickle.dumps(synth), args.repeats)
+    load = best_time(lambda: pickle.loads(pickled), args.repeats)
+    print(f"{'pickle':>8} {len(pickled):>10} {save * 1e3:>9.2f} {load * 1e3:>9.2f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -74,9 +74,15 @@ def macos_archs() -> str:
     return platform.machine()
 
 
+AVX2_FLAGS = "-mavx2 -mfma -DVITAL_AVX2=1"
+
+
 def simd_flags() -> str:
     """Return the architecture-specific compiler flags for the host machine.
 
+    Setting ``VITA_SIMD=avx2`` on x86-64 builds the engine with eight lane AVX2
+    values instead of SSE2. The result only runs on CPUs with AVX2 and FMA.
+
     Returns:
         Flags to pass to the Linux build as ``SIMDFLAGS``.
     """
@@ -85,9 +91,25 @@ def simd_flags() -> str:
         return "-march=armv8-a -mtune=cortex-a53"
     if "arm" in machine:
         return "-march=armv8-a -mtune=cortex-a53 -mfpu=neon-fp-armv8 -mfloat-abi=hard"
+    if os.environ.get("VITA_SIMD", "").lower() == "avx2":
+        return AVX2_FLAGS
     return "-msse2"
 
 
+def builds_avx2_engine() -> bool:
+    """Return whether the Linux build also ships an AVX2 copy of the engine.
+
+    An SSE2 build on x86-64 carries ``libvita_avx2.so`` next to the extension.
+    The extension loads it at import on CPUs with AVX2 and FMA, so one wheel
+    runs everywhere and still uses AVX2 where it can.
+
+    Returns:
+        True when a second, AVX2 build of the engine should be made.
+    """
+    machine = platform.machine().lower()
+    return machine in ("x86_64", "amd64") and simd_flags() == "-msse2"
+
+
 class BuildVitaExtension(build_ext):
     """Compile the Vita extension module and generate its type stubs."""
 
@@ -97,7 +119,7 @@ class BuildVitaExtension(build_ext):
 
         system = platform.system()
         if system == "Linux":
-            binary = self.build_linux()
+            binary = self.build_linux(simd_flags())
         elif system == "Darwin":
             binary = self.build_macos()
         elif system == "Windows":
@@ -112,6 +134,11 @@ class BuildVitaExtension(build_ext):
 
         if system == "Linux":
             subprocess.run(["strip", "--strip-unneeded", str(destination)], check=True)
+            if builds_avx2_engine():
+                avx2_destination = destination.parent / "libvita_avx2.so"
+                shutil.copyfile(self.build_linux(AVX2_FLAGS, "avx2"), avx2_destination)
+                subprocess.run(["strip", "--strip-unneeded", str(avx2_destination)], check=True)
+                print(f"Placed AVX2 engine at {avx2_destination}")
 
         self.generate_stubs(destination.parent)
 
@@ -143,20 +170,30 @@ class BuildVitaExtension(build_ext):
             check=True,
         )
 
-    def build_linux(self) -> Path:
+    def build_linux(self, flags: str, variant: str = "") -> Path:
         """Compile the extension with the Projucer-generated Makefile.
 
+        Args:
+            flags: Instruction set flags, passed to the Makefile as ``SIMDFLAGS``.
+            variant: When not empty, builds into separate object and output
+                directories with this name, so a second build of the engine
+                does not overwrite the first.
+
         Returns:
             Path to the compiled shared object.
         """
         project_dir = THIS_DIR / "headless" / "builds" / "linux"
+        output_dir = f"build/{variant}" if variant else "build"
+        object_dir = f"build/intermediate/Release_{variant}" if variant else "build/intermediate/Release"
         subprocess.run(
             [
                 "make",
                 "-C", str(project_dir),
                 f"-j{os.cpu_count() or 1}",
                 "CONFIG=Release",
-                f"SIMDFLAGS={simd_flags()}",
+                f"JUCE_OBJDIR={object_dir}",
+                f"JUCE_OUTDIR={output_dir}",
+                f"SIMDFLAGS={flags}",
                 "LIBS=-lstdc++fs",
                 # INCLUDEPY and LIBDIR rather than sysconfig.get_paths(): under
                 # build isolation this runs inside a venv, whose 'include' path
@@ -167,7 +204,7 @@ class BuildVitaExtension(build_ext):
             ],
             check=True,
         )
-        return project_dir / "build" / "libvita.so"
+        return project_dir / output_dir / "libvita.so"
 
     def build_macos(self) -> Path:
         """Compile the extension with the Projucer-generated Xcode project.
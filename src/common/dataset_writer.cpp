@@ -0,0 +1,217 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dataset_writer.h"
+
+#include <bitset>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+  // The .npy format wants the header padded so the data starts on a multiple
+  // of this.
+  constexpr size_t kNpyAlignment = 64;
+
+  size_t sampleSize(SynthBase::SampleFormat format) {
+    return format == SynthBase::kFloat32 ? sizeof(float) : sizeof(uint16_t);
+  }
+
+  // Little-endian, which is every platform Vital builds for.
+  const char* npyDescr(SynthBase::SampleFormat format) {
+    if (format == SynthBase::kInt16)
+      return "<i2";
+    if (format == SynthBase::kFloat16)
+      return "<f2";
+    return "<f4";
+  }
+
+  // A version 1.0 .npy header for a C-ordered (num_items, 2, samples) array.
+  std::string npyHeader(SynthBase::SampleFormat format, int64_t num_items, int samples) {
+    std::string dict = std::string("{'descr': '") + npyDescr(format) + "', 'fortran_order': False, 'shape': (" +
+                       std::to_string(num_items) + ", 2, " + std::to_string(samples) + "), }";
+
+    static constexpr char kPreamble[] = "\x93NUMPY\x01\x00";
+    size_t preamble_size = sizeof(kPreamble) - 1 + sizeof(uint16_t);
+    size_t unpadded = preamble_size + dict.size() + 1;
+    size_t padded = (unpadded + kNpyAlignment - 1) / kNpyAlignment * kNpyAlignment;
+    dict.append(padded - unpadded, ' ');
+    dict += '\n';
+
+    std::string header(kPreamble, sizeof(kPreamble) - 1);
+    header += static_cast<char>(dict.size() & 0xff);
+    header += static_cast<char>(dict.size() >> 8);
+    return header + dict;
+  }
+
+  std::string readPrefix(const std::string& path, size_t size) {
+    std::ifstream file(path, std::ios::binary);
+    std::string prefix(size, '\0');
+    file.read(prefix.data(), static_cast<std::streamsize>(size));
+    prefix.resize(static_cast<size_t>(file.gcount()));
+    return prefix;
+  }
+
+  bool fileHasSize(const std::string& path, uintmax_t size) {
+    std::error_code error;
+    return std::filesystem::file_size(path, error) == size && !error;
+  }
+} // namespace
+
+DatasetWriter::DatasetWriter(const std::string& path, int64_t num_items, int samples, const std::string& dtype,
+                             bool overwrite) :
+    path_(path), num_items_(num_items), samples_(samples), format_(SynthBase::sampleFormatFromName(dtype)) {
+  if (num_items <= 0 || samples <= 0)
+    throw std::invalid_argument("num_items and samples must be positive.");
+
+  std::string header = npyHeader(format_, num_items, samples);
+  header_size_ = header.size();
+  uintmax_t data_size = header_size_ + static_cast<uintmax_t>(num_items) * 2 * samples * sampleSize(format_);
+  uintmax_t done_size = (static_cast<uintmax_t>(num_items) + 7) / 8;
+  std::string done_path = path + ".done";
+
+  bool resume = !overwrite && std::filesystem::exists(path);
+  if (resume) {
+    if (readPrefix(path, header.size()) != header || !fileHasSize(path, data_size))
+      throw std::invalid_argument(path + " exists with a different shape or dtype. Pass overwrite=True to replace it.");
+    if (!fileHasSize(done_path, done_size))
+      throw std::invalid_argument(done_path + " is missing or the wrong size, so " + path +
+                                  " cannot be resumed. Pass overwrite=True to replace it.");
+  }
+  else {
+    // Both files start sparse; the data is all zeros and no item is done.
+    std::filesystem::remove(done_path);
+    {
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+      file.write(header.data(), static_cast<std::streamsize>(header.size()));
+      if (!file)
+        throw std::runtime_error("Could not create " + path + ".");
+    }
+    std::ofstream(done_path, std::ios::binary | std::ios::trunc);
+    std::filesystem::resize_file(path, data_size);
+    std::filesystem::resize_file(done_path, done_size);
+  }
+
+  data_ = std::make_unique<MemoryMappedFile>(File(path), MemoryMappedFile::readWrite);
+  done_ = std::make_unique<MemoryMappedFile>(File(done_path), MemoryMappedFile::readWrite);
+  if (data_->getData() == nullptr || done_->getData() == nullptr)
+    throw std::runtime_error("Could not memory map " + path + ".");
+}
+
+DatasetWriter::~DatasetWriter() {
+  close();
+}
+
+std::string DatasetWriter::dtype() const {
+  if (format_ == SynthBase::kInt16)
+    return "int16";
+  if (format_ == SynthBase::kFloat16)
+    return "float16";
+  return "float32";
+}
+
+void DatasetWriter::render(HeadlessSynth& synth, int64_t index, int midi_note, float velocity, float note_dur) {
+  renderBatch(synth, index, { midi_note }, { velocity }, { note_dur });
+}
+
+void DatasetWriter::renderBatch(HeadlessSynth& synth, int64_t first_index, const std::vector<int>& midi_notes,
+                                const std::vector<float>& velocities, const std::vector<float>& note_durs) {
+  size_t num_notes = midi_notes.size();
+  if ((velocities.size() != 1 && velocities.size() != num_notes) ||
+      (note_durs.size() != 1 && note_durs.size() != num_notes)) {
+    throw std::invalid_argument("velocities and note_durs must have one value or one per note.");
+  }
+  if (num_notes == 0)
+    return;
+  checkIndex(first_index);
+  checkIndex(first_index + static_cast<int64_t>(num_notes) - 1);
+
+  std::shared_lock<std::shared_mutex> lock(lock_);
+  if (data_ == nullptr)
+    throw std::runtime_error("DatasetWriter is closed.");
+
+  for (size_t i = 0; i < num_notes; ++i) {
+    int64_t index = first_index + static_cast<int64_t>(i);
+    float velocity = velocities[velocities.size() == 1 ? 0 : i];
+    float note_dur = note_durs[note_durs.size() == 1 ? 0 : i];
+    synth.renderNoteToMemory(midi_notes[i], velocity, note_dur, samples_,
+                             itemChannel(index, 0), itemChannel(index, 1), format_);
+    markDone(index);
+  }
+}
+
+bool DatasetWriter::isDone(int64_t index) {
+  checkIndex(index);
+  std::lock_guard<std::mutex> lock(done_mutex_);
+  if (done_ == nullptr)
+    throw std::runtime_error("DatasetWriter is closed.");
+
+  const uint8_t* bits = static_cast<const uint8_t*>(done_->getData());
+  return bits[index / 8] & (1 << (index % 8));
+}
+
+int64_t DatasetWriter::numDone() {
+  std::lock_guard<std::mutex> lock(done_mutex_);
+  if (done_ == nullptr)
+    throw std::runtime_error("DatasetWriter is closed.");
+
+  const uint8_t* bits = static_cast<const uint8_t*>(done_->getData());
+  int64_t total = 0;
+  for (int64_t i = 0; i < (num_items_ + 7) / 8; ++i)
+    total += std::bitset<8>(bits[i]).count();
+  return total;
+}
+
+std::vector<int64_t> DatasetWriter::pendingItems() {
+  std::lock_guard<std::mutex> lock(done_mutex_);
+  if (done_ == nullptr)
+    throw std::runtime_error("DatasetWriter is closed.");
+
+  const uint8_t* bits = static_cast<const uint8_t*>(done_->getData());
+  std::vector<int64_t> pending;
+  for (int64_t i = 0; i < num_items_; ++i) {
+    if ((bits[i / 8] & (1 << (i % 8))) == 0)
+      pending.push_back(i);
+  }
+  return pending;
+}
+
+void DatasetWriter::close() {
+  std::unique_lock<std::shared_mutex> lock(lock_);
+  std::lock_guard<std::mutex> done_lock(done_mutex_);
+  data_.reset();
+  done_.reset();
+}
+
+void DatasetWriter::checkIndex(int64_t index) const {
+  if (index < 0 || index >= num_items_)
+    throw std::out_of_range("Item " + std::to_string(index) + " is out of range for " +
+                            std::to_string(num_items_) + " items.");
+}
+
+void* DatasetWriter::itemChannel(int64_t index, int channel) const {
+  size_t offset = header_size_ + (static_cast<size_t>(index) * 2 + channel) * samples_ * sampleSize(format_);
+  return static_cast<uint8_t*>(data_->getData()) + offset;
+}
+
+void DatasetWriter::markDone(int64_t index) {
+  // The item's audio is already in the shared mapping, so once the bit is set
+  // both are in the page cache and survive the process being killed.
+  std::lock_guard<std::mutex> lock(done_mutex_);
+  uint8_t* bits = static_cast<uint8_t*>(done_->getData());
+  bits[index / 8] |= static_cast<uint8_t>(1 << (index % 8));
+}
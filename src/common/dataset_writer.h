@@ -0,0 +1,84 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synth_base.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// A (num_items, 2, samples) .npy file, memory mapped, that synths render into
+// one item at a time. Each item is written in place by the render loop, so no
+// buffer of it exists anywhere else, and different items can be written from
+// different threads, each with its own Synth. A sidecar file next to the data,
+// path + ".done", holds one bit per finished item: opening an existing dataset
+// with the same shape and dtype resumes it with those items still done.
+class DatasetWriter {
+  public:
+    // Creates the file, or reopens it if it already holds a dataset of this
+    // shape and dtype. overwrite replaces an existing file instead. dtype is
+    // "float32", "int16" or "float16".
+    DatasetWriter(const std::string& path, int64_t num_items, int samples, const std::string& dtype,
+                  bool overwrite);
+    ~DatasetWriter();
+
+    // Renders one note into item index and marks it done. Takes the synth's
+    // critical section; call without the GIL.
+    void render(HeadlessSynth& synth, int64_t index, int midi_note, float velocity, float note_dur);
+
+    // Renders midi_notes into consecutive items from first_index on.
+    // velocities and note_durs have one entry or one per note.
+    void renderBatch(HeadlessSynth& synth, int64_t first_index, const std::vector<int>& midi_notes,
+                     const std::vector<float>& velocities, const std::vector<float>& note_durs);
+
+    bool isDone(int64_t index);
+    int64_t numDone();
+    // Items not yet done, in order: what is left to render when resuming.
+    std::vector<int64_t> pendingItems();
+
+    // Unmaps both files. Renders in progress finish first; later ones raise.
+    // Safe to call more than once.
+    void close();
+
+    const std::string& path() const { return path_; }
+    int64_t numItems() const { return num_items_; }
+    int samples() const { return samples_; }
+    std::string dtype() const;
+
+  private:
+    void checkIndex(int64_t index) const;
+    void* itemChannel(int64_t index, int channel) const;
+    void markDone(int64_t index);
+
+    std::string path_;
+    int64_t num_items_;
+    int samples_;
+    SynthBase::SampleFormat format_;
+    size_t header_size_;
+
+    // Renders share lock_ while they write; close takes it exclusively.
+    std::shared_mutex lock_;
+    std::unique_ptr<MemoryMappedFile> data_;
+    std::unique_ptr<MemoryMappedFile> done_;
+    std::mutex done_mutex_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DatasetWriter)
+};
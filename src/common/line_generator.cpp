@@ -162,6 +162,27 @@ void LineGenerator::jsonToState(json data) {
   render();
 }
 
+void LineGenerator::copy(const LineGenerator* other) {
+  name_ = other->name_;
+  last_browsed_file_ = other->last_browsed_file_;
+  num_points_ = other->num_points_;
+  for (int i = 0; i < num_points_; ++i) {
+    points_[i] = other->points_[i];
+    powers_[i] = other->powers_[i];
+  }
+  loop_ = other->loop_;
+  smooth_ = other->smooth_;
+  linear_ = other->linear_;
+
+  if (resolution_ != other->resolution_) {
+    render();
+    return;
+  }
+
+  render_count_++;
+  memcpy(buffer_.get(), other->buffer_.get(), (resolution_ + kExtraValues) * sizeof(vital::mono_float));
+}
+
 void LineGenerator::render() {
   render_count_++;
 
@@ -46,6 +46,7 @@ class LineGenerator {
     void initSawUp();
     void initSawDown();
     void render();
+    void copy(const LineGenerator* other);
     json stateToJson();
     static bool isValidJson(json data);
     void jsonToState(json data);
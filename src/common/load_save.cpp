@@ -45,6 +45,12 @@ namespace {
 
     return Time(year, month, day, hour, minute);
   }
+
+  const char kBinaryStateMagic[] = { 'V', 'T', 'S', 'B' };
+
+  // The scale vital::utils uses for 16-bit PCM. Rounding rather than
+  // truncating gets back the exact PCM of audio that was loaded from it.
+  constexpr float kPcmScale = 32767.0f;
 } // namespace
 
 const std::string LoadSave::kUserDirectoryName = "User";
@@ -101,6 +107,26 @@ json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_sec
   if (sample)
     settings_data["sample"] = sample->stateToJson();
 
+  settings_data["modulations"] = modulationsToJson(synth);
+
+  if (synth->getWavetableCreator(0)) {
+    json wavetables;
+    for (int i = 0; i < vital::kNumOscillators; ++i) {
+      WavetableCreator* wavetable_creator = synth->getWavetableCreator(i);
+      wavetables.push_back(wavetable_creator->stateToJson());
+    }
+
+    settings_data["wavetables"] = wavetables;
+  }
+
+  settings_data["lfos"] = lfosToJson(synth);
+
+  json data = presetInfoToJson(synth);
+  data["settings"] = settings_data;
+  return data;
+}
+
+json LoadSave::modulationsToJson(SynthBase* synth) {
   json modulations;
   vital::ModulationConnectionBank& modulation_bank = synth->getModulationBank();
   for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
@@ -115,27 +141,19 @@ json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_sec
 
     modulations.push_back(modulation_data);
   }
+  return modulations;
+}
 
-  settings_data["modulations"] = modulations;
-
-  if (synth->getWavetableCreator(0)) {
-    json wavetables;
-    for (int i = 0; i < vital::kNumOscillators; ++i) {
-      WavetableCreator* wavetable_creator = synth->getWavetableCreator(i);
-      wavetables.push_back(wavetable_creator->stateToJson());
-    }
-
-    settings_data["wavetables"] = wavetables;
-  }
-
+json LoadSave::lfosToJson(SynthBase* synth) {
   json lfos;
   for (int i = 0; i < vital::kNumLfos; ++i) {
     LineGenerator* lfo_source = synth->getLfoSource(i);
     lfos.push_back(lfo_source->stateToJson());
   }
+  return lfos;
+}
 
-  settings_data["lfos"] = lfos;
-
+json LoadSave::presetInfoToJson(SynthBase* synth) {
   json data;
   data["synth_version"] = ProjectInfo::versionString;
   data["preset_name"] = synth->getPresetName().toStdString();
@@ -146,25 +164,24 @@ json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_sec
     std::string name = synth->getMacroName(i).toStdString();
     data["macro" + std::to_string(i + 1)] = name;
   }
-  data["settings"] = settings_data;
   return data;
 }
 
 void LoadSave::loadControls(SynthBase* synth, const json& data) {
-  vital::control_map controls = synth->getControls();
-  for (auto& control : controls) {
-    std::string name = control.first;
-    if (data.count(name)) {
-      vital::mono_float value = data[name];
-      control.second->set(value);
-    }
-    else {
-      vital::ValueDetails details = vital::Parameters::getDetails(name);
-      control.second->set(details.default_value);
-    }
+  const std::vector<vital::Value*>& controls = synth->getControlTable();
+  for (int i = 0; i < static_cast<int>(controls.size()); ++i) {
+    if (controls[i] == nullptr)
+      continue;
+
+    const vital::ValueDetails* details = vital::Parameters::getDetails(i);
+    auto value = data.find(details->name);
+    if (value != data.end())
+      controls[i]->set(value->get<vital::mono_float>());
+    else
+      controls[i]->set(details->default_value);
   }
 
-  synth->modWheelGuiChanged(controls["mod_wheel"]->value());
+  synth->modWheelGuiChanged(synth->getControls()["mod_wheel"]->value());
 }
 
 void LoadSave::loadModulations(SynthBase* synth, const json& modulations) {
@@ -1052,6 +1069,245 @@ bool LoadSave::jsonToState(SynthBase* synth, std::map<std::string, String>& save
   return true;
 }
 
+MemoryBlock LoadSave::stateToBinary(SynthBase* synth, const CriticalSection& critical_section) {
+  MemoryOutputStream stream;
+  stream.write(kBinaryStateMagic, sizeof(kBinaryStateMagic));
+  stream.writeInt(kBinaryStateVersion);
+  stream.writeInt(synth->getSampleRate());
+
+  const std::vector<vital::Value*>& controls = synth->getControlTable();
+  int num_parameters = vital::Parameters::getNumParameters();
+  stream.writeInt(num_parameters);
+  for (int i = 0; i < num_parameters; ++i)
+    stream.writeFloat(controls[i] ? controls[i]->value() : vital::Parameters::getDetails(i)->default_value);
+
+  vital::Sample* sample = synth->getSample();
+  stream.writeBool(sample != nullptr);
+  if (sample) {
+    stream.writeString(sample->getName());
+    stream.writeInt(sample->originalLength());
+    stream.writeInt(sample->sampleRate());
+    stream.writeBool(sample->isStereo());
+    writeAudioBinary(stream, sample->originalLeftBuffer(), sample->originalLength());
+    if (sample->isStereo())
+      writeAudioBinary(stream, sample->originalRightBuffer(), sample->originalLength());
+  }
+
+  json data = presetInfoToJson(synth);
+  data["settings"]["modulations"] = modulationsToJson(synth);
+  data["settings"]["lfos"] = lfosToJson(synth);
+  std::vector<uint8_t> cbor = json::to_cbor(data);
+  stream.writeInt(static_cast<int>(cbor.size()));
+  stream.write(cbor.data(), cbor.size());
+
+  int num_wavetables = synth->getWavetableCreator(0) ? vital::kNumOscillators : 0;
+  stream.writeInt(num_wavetables);
+  for (int i = 0; i < num_wavetables; ++i)
+    synth->getWavetableCreator(i)->stateToBinary(stream);
+
+  // Reads past the end return zeros, so a truncated state is caught by this
+  // closing magic not matching.
+  stream.write(kBinaryStateMagic, sizeof(kBinaryStateMagic));
+  return stream.getMemoryBlock();
+}
+
+LoadSave::BinaryState::BinaryState() : sample_rate(0), has_sample(false), sample_length(0), sample_sample_rate(0) { }
+
+LoadSave::BinaryState::~BinaryState() = default;
+
+std::unique_ptr<LoadSave::BinaryState> LoadSave::parseBinaryState(SynthBase* synth, const void* data, size_t size) {
+  MemoryInputStream stream(data, size, false);
+  char magic[sizeof(kBinaryStateMagic)];
+  if (stream.read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, kBinaryStateMagic, sizeof(magic)) ||
+      stream.readInt() != kBinaryStateVersion) {
+    return nullptr;
+  }
+
+  std::unique_ptr<BinaryState> state = std::make_unique<BinaryState>();
+  state->sample_rate = stream.readInt();
+  if (state->sample_rate <= 0)
+    return nullptr;
+
+  int num_parameters = stream.readInt();
+  if (num_parameters != vital::Parameters::getNumParameters())
+    return nullptr;
+  state->control_values.resize(num_parameters);
+  int control_bytes = num_parameters * sizeof(float);
+  if (stream.read(state->control_values.data(), control_bytes) != control_bytes)
+    return nullptr;
+
+  state->has_sample = stream.readBool();
+  if (state->has_sample) {
+    state->sample_name = stream.readString().toStdString();
+    state->sample_length = stream.readInt();
+    state->sample_sample_rate = stream.readInt();
+    bool stereo = stream.readBool();
+    int sample_length = state->sample_length;
+    if (sample_length < 0 || sample_length * sizeof(int16_t) > static_cast<size_t>(stream.getNumBytesRemaining()))
+      return nullptr;
+
+    state->sample_left = std::make_unique<float[]>(sample_length);
+    if (!readAudioBinary(stream, state->sample_left.get(), sample_length))
+      return nullptr;
+    if (stereo) {
+      state->sample_right = std::make_unique<float[]>(sample_length);
+      if (!readAudioBinary(stream, state->sample_right.get(), sample_length))
+        return nullptr;
+    }
+  }
+
+  int cbor_size = stream.readInt();
+  if (cbor_size < 0 || cbor_size > stream.getNumBytesRemaining())
+    return nullptr;
+  std::vector<uint8_t> cbor(cbor_size);
+  stream.read(cbor.data(), cbor_size);
+
+  json json_state = json::from_cbor(cbor);
+  if (!json_state.is_object() || !json_state["settings"].is_object())
+    return nullptr;
+  json& settings = json_state["settings"];
+  json& modulations = settings["modulations"];
+  json& lfos = settings["lfos"];
+  if (!modulations.is_array() || static_cast<int>(modulations.size()) > vital::kMaxModulationConnections ||
+      !lfos.is_array() || static_cast<int>(lfos.size()) > vital::kNumLfos) {
+    return nullptr;
+  }
+
+  // LineGenerator::jsonToState trusts num_points.
+  auto valid_line = [](const json& line) {
+    if (!line.is_object() || !line.count("num_points") || !line.at("num_points").is_number_integer())
+      return false;
+    int num_points = line.at("num_points");
+    return num_points >= 0 && num_points <= LineGenerator::kMaxPoints;
+  };
+
+  for (const json& modulation : modulations) {
+    BinaryState::Modulation parsed;
+    parsed.source = modulation.at("source").get<std::string>();
+    parsed.destination = modulation.at("destination").get<std::string>();
+    if (modulation.count("line_mapping")) {
+      if (!valid_line(modulation.at("line_mapping")))
+        return nullptr;
+      parsed.line_mapping = std::make_unique<LineGenerator>();
+      parsed.line_mapping->jsonToState(modulation.at("line_mapping"));
+    }
+    state->modulations.push_back(std::move(parsed));
+  }
+
+  for (size_t i = 0; i < lfos.size(); ++i) {
+    if (!valid_line(lfos[i]))
+      return nullptr;
+    state->lfos.push_back(std::make_unique<LineGenerator>(synth->getLfoSource(static_cast<int>(i))->resolution()));
+    state->lfos.back()->jsonToState(lfos[i]);
+  }
+
+  int num_wavetables = stream.readInt();
+  if (num_wavetables < 0 || num_wavetables > vital::kNumOscillators)
+    return nullptr;
+  for (int i = 0; i < num_wavetables; ++i) {
+    state->wavetables.push_back(std::make_unique<vital::Wavetable>(vital::kNumOscillatorWaveFrames));
+    state->wavetable_creators.push_back(std::make_unique<WavetableCreator>(state->wavetables.back().get()));
+    if (!state->wavetable_creators.back()->binaryToState(stream))
+      return nullptr;
+  }
+
+  if (stream.read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, kBinaryStateMagic, sizeof(magic)) ||
+      !stream.isExhausted()) {
+    return nullptr;
+  }
+
+  loadSaveState(state->save_info, json_state);
+  return state;
+}
+
+void LoadSave::applyBinaryState(SynthBase* synth, std::map<std::string, String>& save_info,
+                                BinaryState& state) {
+  if (synth->getSampleRate() != state.sample_rate)
+    synth->setSampleRate(state.sample_rate);
+
+  const std::vector<vital::Value*>& controls = synth->getControlTable();
+  for (size_t i = 0; i < state.control_values.size(); ++i) {
+    if (controls[i])
+      controls[i]->set(state.control_values[i]);
+  }
+  synth->modWheelGuiChanged(synth->getControls()["mod_wheel"]->value());
+
+  synth->clearModulations();
+  vital::ModulationConnectionBank& modulation_bank = synth->getModulationBank();
+  for (size_t i = 0; i < state.modulations.size(); ++i) {
+    const BinaryState::Modulation& modulation = state.modulations[i];
+    vital::ModulationConnection* connection = modulation_bank.atIndex(static_cast<int>(i));
+    if (synth->getEngine()->getModulationSource(modulation.source) == nullptr ||
+        synth->getEngine()->getMonoModulationDestination(modulation.destination) == nullptr) {
+      continue;
+    }
+
+    if (modulation.source.length() && modulation.destination.length()) {
+      connection->source_name = modulation.source;
+      connection->destination_name = modulation.destination;
+      synth->connectModulation(connection);
+    }
+
+    if (modulation.line_mapping)
+      connection->modulation_processor->lineMapGenerator()->copy(modulation.line_mapping.get());
+    else
+      connection->modulation_processor->lineMapGenerator()->initLinear();
+  }
+
+  vital::Sample* sample = synth->getSample();
+  if (sample && state.has_sample) {
+    if (state.sample_right)
+      sample->loadSample(state.sample_left.get(), state.sample_right.get(), state.sample_length,
+                         state.sample_sample_rate);
+    else
+      sample->loadSample(state.sample_left.get(), state.sample_length, state.sample_sample_rate);
+    sample->setName(state.sample_name);
+  }
+
+  if (synth->getWavetableCreator(0)) {
+    for (size_t i = 0; i < state.wavetable_creators.size(); ++i)
+      synth->getWavetableCreator(static_cast<int>(i))->takeFrom(state.wavetable_creators[i].get());
+  }
+  for (size_t i = 0; i < state.lfos.size(); ++i)
+    synth->getLfoSource(static_cast<int>(i))->copy(state.lfos[i].get());
+
+  for (const auto& info : state.save_info)
+    save_info[info.first] = info.second;
+  synth->checkOversampling();
+}
+
+void LoadSave::writeAudioBinary(MemoryOutputStream& stream, const float* data, int num) {
+  std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(num);
+  for (int i = 0; i < num; ++i)
+    pcm_data[i] = static_cast<int16_t>(std::round(vital::utils::clamp(data[i], -1.0f, 1.0f) * kPcmScale));
+  std::unique_ptr<float[]> float_data = std::make_unique<float[]>(num);
+  vital::utils::pcmToFloatData(float_data.get(), pcm_data.get(), num);
+
+  bool pcm = num == 0 || memcmp(float_data.get(), data, num * sizeof(float)) == 0;
+  stream.writeBool(pcm);
+  if (pcm)
+    stream.write(pcm_data.get(), num * sizeof(int16_t));
+  else
+    stream.write(data, num * sizeof(float));
+}
+
+bool LoadSave::readAudioBinary(MemoryInputStream& stream, float* dest, int num) {
+  if (num < 0)
+    return false;
+
+  if (!stream.readBool()) {
+    int num_bytes = num * sizeof(float);
+    return stream.read(dest, num_bytes) == num_bytes;
+  }
+
+  int num_bytes = num * sizeof(int16_t);
+  std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(num);
+  if (stream.read(pcm_data.get(), num_bytes) != num_bytes)
+    return false;
+  vital::utils::pcmToFloatData(dest, pcm_data.get(), num);
+  return true;
+}
+
 String LoadSave::getAuthorFromFile(const File& file) {
   static constexpr int kMaxCharacters = 40;
   static constexpr int kMinSize = 60;
@@ -20,17 +20,22 @@
 #include "json/json.h"
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
 namespace vital {
   class StringLayout;
+  class Wavetable;
 }
 
+class LineGenerator;
 class MidiManager;
 class SynthBase;
+class WavetableCreator;
 
 class LoadSave {
   public:
@@ -72,6 +77,9 @@ class LoadSave {
     static void convertBufferToPcm(json& data, const std::string& field);
     static void convertPcmToFloatBuffer(json& data, const std::string& field);
     static json stateToJson(SynthBase* synth, const CriticalSection& critical_section);
+    static json modulationsToJson(SynthBase* synth);
+    static json lfosToJson(SynthBase* synth);
+    static json presetInfoToJson(SynthBase* synth);
 
     static void loadControls(SynthBase* synth, const json& data);
     static void loadModulations(SynthBase* synth, const json& modulations);
@@ -84,6 +92,52 @@ class LoadSave {
     static json updateFromOldVersion(json state);
     static bool jsonToState(SynthBase* synth, std::map<std::string, String>& save_info, json state);
 
+    // A binary state read and checked in full, with its wavetables and LFO
+    // shapes already rendered into scratch objects. Applying it can't fail.
+    struct BinaryState {
+      struct Modulation {
+        std::string source;
+        std::string destination;
+        std::unique_ptr<LineGenerator> line_mapping;
+      };
+
+      BinaryState();
+      ~BinaryState();
+
+      int sample_rate;
+      std::vector<float> control_values;
+      std::vector<Modulation> modulations;
+
+      bool has_sample;
+      std::string sample_name;
+      int sample_length;
+      int sample_sample_rate;
+      std::unique_ptr<float[]> sample_left;
+      std::unique_ptr<float[]> sample_right;
+
+      std::vector<std::unique_ptr<vital::Wavetable>> wavetables;
+      std::vector<std::unique_ptr<WavetableCreator>> wavetable_creators;
+      std::vector<std::unique_ptr<LineGenerator>> lfos;
+      std::map<std::string, String> save_info;
+    };
+
+    // Compact state for pickling and the like: the sample rate, control values
+    // by parameter index, the raw sample and each WavetableCreator's binary
+    // state, with modulations, LFO shapes and preset info as CBOR. Only
+    // readable by a build with the same kBinaryStateVersion.
+    static constexpr int kBinaryStateVersion = 3;
+    static MemoryBlock stateToBinary(SynthBase* synth, const CriticalSection& critical_section);
+    // Returns nullptr if data isn't a valid state. Doesn't change the synth.
+    static std::unique_ptr<BinaryState> parseBinaryState(SynthBase* synth, const void* data, size_t size);
+    // Moves the wavetable groups out of state rather than copying them.
+    static void applyBinaryState(SynthBase* synth, std::map<std::string, String>& save_info,
+                                 BinaryState& state);
+
+    // Writes num samples as 16-bit PCM when that loses nothing, which holds
+    // for any audio that came from a preset, and as float otherwise.
+    static void writeAudioBinary(MemoryOutputStream& stream, const float* data, int num);
+    static bool readAudioBinary(MemoryInputStream& stream, float* dest, int num);
+
     static String getAuthorFromFile(const File& file);
     static String getStyleFromFile(const File& file);
     static std::string getAuthor(json file);
@@ -120,6 +120,7 @@ class MidiManager : public MidiInputCallback {
     force_inline int upperMasterChannel() { return mpe_zone_layout_.getUpperZone().getMasterChannel() - 1; }
 
     void setMpeEnabled(bool enabled) { mpe_enabled_ = enabled; }
+    bool isMpeEnabled() const { return mpe_enabled_; }
 
     midi_map getMidiLearnMap() { return midi_learn_map_; }
     void setMidiLearnMap(const midi_map& midi_learn_map) { midi_learn_map_ = midi_learn_map; }
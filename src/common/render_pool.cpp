@@ -0,0 +1,361 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+  bool isPresetJson(const std::string& preset) {
+    size_t start = preset.find_first_not_of(" \t\r\n");
+    return start != std::string::npos && preset[start] == '{';
+  }
+} // namespace
+
+bool RenderFuture::done() {
+  std::lock_guard<std::mutex> lock(job_->mutex);
+  return job_->done;
+}
+
+nb::object RenderFuture::result(std::optional<double> timeout) {
+  if (result_.is_valid())
+    return result_;
+
+  bool finished = true;
+  {
+    nb::gil_scoped_release gil_release;
+    std::unique_lock<std::mutex> lock(job_->mutex);
+    if (!timeout)
+      job_->finished.wait(lock, [this] { return job_->done; });
+    else {
+      finished = job_->finished.wait_for(lock, std::chrono::duration<double>(*timeout),
+                                         [this] { return job_->done; });
+    }
+  }
+
+  if (!finished) {
+    PyErr_SetString(PyExc_TimeoutError, "Render did not finish within the timeout.");
+    throw nb::python_error();
+  }
+  if (!job_->error.empty())
+    throw std::runtime_error(job_->error);
+
+  // Another thread, a callback say, may have waited on this future too and
+  // taken the GIL back first. Only one of us may hand the audio to numpy.
+  if (result_.is_valid())
+    return result_;
+
+  // The worker is done with the job, so the audio is ours to hand to numpy.
+  nb::capsule owner(job_->audio.get(), [](void* p) noexcept { delete[] (float*)p; });
+  float* raw_data = job_->audio.release();
+  size_t num_notes = job_->midi_notes.size();
+  result_ = nb::cast(nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy>(
+      raw_data, {num_notes, 2, static_cast<size_t>(job_->total_samples)}, owner));
+  return result_;
+}
+
+RenderPool::RenderPool(int num_threads, float sample_rate) {
+  if (num_threads <= 0)
+    throw std::invalid_argument("num_threads must be positive.");
+  if (sample_rate <= 0.0f)
+    throw std::invalid_argument("sample_rate must be positive.");
+
+  nb::gil_scoped_release gil_release;
+  for (int i = 0; i < num_threads; ++i) {
+    std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+    worker->synth = std::make_unique<HeadlessSynth>();
+    worker->synth->setSampleRate(sample_rate);
+    workers_.push_back(std::move(worker));
+  }
+
+  for (auto& worker : workers_)
+    worker->thread = std::thread(&RenderPool::run, this, worker.get());
+}
+
+RenderPool::~RenderPool() {
+  close();
+}
+
+nb::object RenderPool::submit(const std::string& preset, const std::vector<int>& midi_notes,
+                              float velocity, float note_dur, float render_dur, nb::object callback) {
+  if (midi_notes.empty())
+    throw std::invalid_argument("midi_notes must not be empty.");
+
+  std::shared_ptr<RenderJob> job = std::make_shared<RenderJob>();
+  job->preset = preset;
+  job->midi_notes = midi_notes;
+  job->velocity = velocity;
+  job->note_dur = note_dur;
+  job->render_dur = render_dur;
+
+  // The callback gets the same Python object submit returns, so it has to
+  // exist before the job is queued.
+  nb::object future = nb::cast(new RenderFuture(job), nb::rv_policy::take_ownership);
+  if (!callback.is_none()) {
+    job->callback = std::make_unique<nb::object>(callback);
+    job->future = std::make_unique<nb::object>(future);
+  }
+
+  bool queued = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!closed_) {
+      queue_.push_back(job);
+      queued = true;
+    }
+  }
+
+  if (!queued) {
+    job->callback.reset();
+    job->future.reset();
+    throw std::runtime_error("RenderPool is closed.");
+  }
+
+  queue_changed_.notify_one();
+  return future;
+}
+
+void RenderPool::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  queue_changed_.notify_all();
+
+  // Workers take the GIL to run callbacks, so joining them while holding it
+  // could deadlock.
+  std::optional<nb::gil_scoped_release> gil_release;
+  if (PyGILState_Check())
+    gil_release.emplace();
+
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable())
+      worker->thread.join();
+  }
+}
+
+void RenderPool::run(Worker* worker) {
+  while (true) {
+    std::shared_ptr<RenderJob> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_changed_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+      if (queue_.empty())
+        return;
+
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    renderJob(worker, job.get());
+    finishJob(job.get());
+  }
+}
+
+void RenderPool::renderJob(Worker* worker, RenderJob* job) {
+  try {
+    // Jobs never change a synth's settings, so one that already has the
+    // preset loaded can render straight away. A file rewritten since it was
+    // loaded is loaded again.
+    bool is_json = isPresetJson(job->preset);
+    File file;
+    std::string key = job->preset;
+    Time modified;
+    int64 size = -1;
+    if (!is_json) {
+      file = File::getCurrentWorkingDirectory().getChildFile(job->preset);
+      key = file.getFullPathName().toStdString();
+      modified = file.getLastModificationTime();
+      size = file.getSize();
+    }
+
+    if (worker->loaded_preset != key || worker->loaded_modified != modified || worker->loaded_size != size) {
+      worker->loaded_preset.clear();
+      std::string error;
+      bool loaded;
+      if (is_json)
+        loaded = worker->synth->loadFromString(job->preset);
+      else
+        loaded = worker->synth->loadFromFile(file, error);
+
+      if (!loaded) {
+        job->error = error.empty() ? "Could not load preset " + job->preset.substr(0, 200) : error;
+        return;
+      }
+      worker->loaded_preset = key;
+      worker->loaded_modified = modified;
+      worker->loaded_size = size;
+    }
+
+    job->audio = worker->synth->renderBatchToBuffer(job->midi_notes, { job->velocity }, { job->note_dur },
+                                                    job->render_dur, false, SynthBase::kDefaultTailThresholdDb,
+                                                    SynthBase::kDefaultTailHold, job->total_samples);
+  }
+  catch (const std::exception& e) {
+    job->error = e.what();
+  }
+}
+
+void RenderPool::finishJob(RenderJob* job) {
+  {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->done = true;
+  }
+  job->finished.notify_all();
+
+  if (job->callback) {
+    nb::gil_scoped_acquire gil;
+    try {
+      (*job->callback)(*job->future);
+    }
+    catch (nb::python_error& e) {
+      e.discard_as_unraisable("RenderPool callback");
+    }
+    job->callback.reset();
+    job->future.reset();
+  }
+}
+
+AsyncRenderer* AsyncRenderer::instance_ = nullptr;
+
+AsyncRenderer::AsyncRenderer(int num_threads) {
+  for (int i = 0; i < num_threads; ++i)
+    threads_.emplace_back(&AsyncRenderer::run, this);
+}
+
+nb::object AsyncRenderer::submit(HeadlessSynth& synth, int midi_note, float velocity, float note_dur,
+                                 float render_dur) {
+  // Raises RuntimeError outside a coroutine, before anything is queued.
+  nb::object loop = nb::module_::import_("asyncio").attr("get_running_loop")();
+  nb::object future = loop.attr("create_future")();
+
+  std::unique_ptr<AsyncRenderJob> job = std::make_unique<AsyncRenderJob>();
+  job->synth = &synth;
+  job->midi_note = midi_note;
+  job->velocity = velocity;
+  job->note_dur = note_dur;
+  job->render_dur = render_dur;
+  job->synth_object = std::make_unique<nb::object>(nb::find(synth));
+  job->loop = std::make_unique<nb::object>(loop);
+  job->future = std::make_unique<nb::object>(future);
+
+  // submit and shutdown both hold the GIL, so it guards instance_.
+  if (instance_ == nullptr)
+    instance_ = new AsyncRenderer(std::max(1u, std::thread::hardware_concurrency()));
+
+  {
+    std::lock_guard<std::mutex> lock(instance_->mutex_);
+    instance_->queue_.push_back(std::move(job));
+  }
+  instance_->queue_changed_.notify_one();
+  return future;
+}
+
+void AsyncRenderer::shutdown() {
+  if (instance_ == nullptr)
+    return;
+
+  AsyncRenderer* renderer = instance_;
+  instance_ = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(renderer->mutex_);
+    renderer->closed_ = true;
+  }
+  renderer->queue_changed_.notify_all();
+
+  // Workers take the GIL to finish their jobs.
+  {
+    nb::gil_scoped_release gil_release;
+    for (std::thread& thread : renderer->threads_)
+      thread.join();
+  }
+  delete renderer;
+}
+
+void AsyncRenderer::run() {
+  while (true) {
+    std::unique_ptr<AsyncRenderJob> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_changed_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+      if (queue_.empty())
+        return;
+
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    renderJob(job.get());
+    finishJob(std::move(job));
+  }
+}
+
+void AsyncRenderer::renderJob(AsyncRenderJob* job) {
+  try {
+    job->audio = job->synth->renderBatchToBuffer({ job->midi_note }, { job->velocity }, { job->note_dur },
+                                                 job->render_dur, false, SynthBase::kDefaultTailThresholdDb,
+                                                 SynthBase::kDefaultTailHold, job->total_samples);
+  }
+  catch (const std::exception& e) {
+    job->error = e.what();
+  }
+}
+
+void AsyncRenderer::finishJob(std::unique_ptr<AsyncRenderJob> job) {
+  nb::gil_scoped_acquire gil;
+  try {
+    nb::object result;
+    if (job->error.empty()) {
+      // Handing the audio to numpy can fail as well, out of memory say. The
+      // future gets that like a render error; it must not leave this thread.
+      try {
+        nb::capsule owner(job->audio.get(), [](void* p) noexcept { delete[] (float*)p; });
+        float* raw_data = job->audio.release();
+        result = nb::cast(nb::ndarray<float, nb::shape<2, -1>, nb::numpy>(
+            raw_data, {2, static_cast<size_t>(job->total_samples)}, owner));
+      }
+      catch (const std::exception& e) {
+        job->error = e.what();
+      }
+    }
+    if (!job->error.empty())
+      result = nb::module_::import_("builtins").attr("RuntimeError")(nb::str(job->error.c_str()));
+
+    // The future can only be completed on its loop's thread, and may have
+    // been cancelled by the time the loop gets to it. A closed loop has
+    // nobody left waiting.
+    nb::object complete = nb::cpp_function([](nb::object future, nb::object result, bool failed) {
+      if (nb::cast<bool>(future.attr("done")()))
+        return;
+      future.attr(failed ? "set_exception" : "set_result")(result);
+    });
+    if (!nb::cast<bool>(job->loop->attr("is_closed")()))
+      job->loop->attr("call_soon_threadsafe")(complete, *job->future, result, !job->error.empty());
+  }
+  catch (nb::python_error& e) {
+    e.discard_as_unraisable("Synth.render_async");
+  }
+  catch (const std::exception& e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    nb::python_error().discard_as_unraisable("Synth.render_async");
+  }
+
+  job->future.reset();
+  job->loop.reset();
+  job->synth_object.reset();
+}
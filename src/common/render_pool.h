@@ -0,0 +1,165 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synth_base.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A job handed to a RenderPool and, once a worker has rendered it, its result.
+// Shared between the submitting thread and the worker; everything here is
+// plain C++ so the worker never needs the GIL except to run a callback.
+struct RenderJob {
+  std::string preset;
+  std::vector<int> midi_notes;
+  float velocity = 0.0f;
+  float note_dur = 0.0f;
+  float render_dur = 0.0f;
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  bool done = false;
+  std::unique_ptr<float[]> audio;
+  int total_samples = 0;
+  std::string error;
+
+  // Python objects, only touched with the GIL held. The worker drops them
+  // after running the callback, which also breaks the cycle between them.
+  std::unique_ptr<nb::object> callback;
+  std::unique_ptr<nb::object> future;
+};
+
+// What RenderPool.submit returns: a handle on one job.
+class RenderFuture {
+  public:
+    explicit RenderFuture(std::shared_ptr<RenderJob> job) : job_(std::move(job)) { }
+
+    bool done();
+
+    // Waits for the job, with the GIL released, and returns its audio as a
+    // (num_notes, 2, num_samples) array. No timeout waits forever.
+    nb::object result(std::optional<double> timeout);
+
+  private:
+    std::shared_ptr<RenderJob> job_;
+    nb::object result_;
+};
+
+// A fixed set of worker threads, each with its own HeadlessSynth. Jobs load a
+// preset, skipped when the worker's synth already has it, and render a batch
+// of notes. Dispatch and rendering happen entirely in C++.
+class RenderPool {
+  public:
+    RenderPool(int num_threads, float sample_rate);
+    ~RenderPool();
+
+    // Queues a job and returns its RenderFuture. preset is a path to a preset
+    // file or a preset's JSON text. A callback that is not None is called with
+    // the future, on the worker thread, once the job is done. Call with the
+    // GIL held.
+    nb::object submit(const std::string& preset, const std::vector<int>& midi_notes,
+                      float velocity, float note_dur, float render_dur, nb::object callback);
+
+    // Renders everything already queued, then stops the workers. Further
+    // submits raise. Safe to call more than once.
+    void close();
+
+    int numThreads() const { return static_cast<int>(workers_.size()); }
+
+  private:
+    struct Worker {
+      std::unique_ptr<HeadlessSynth> synth;
+      // What the synth last loaded: the JSON itself, or a file's full path
+      // with the modification time and size it had then.
+      std::string loaded_preset;
+      Time loaded_modified;
+      int64 loaded_size = -1;
+      std::thread thread;
+    };
+
+    void run(Worker* worker);
+    void renderJob(Worker* worker, RenderJob* job);
+    void finishJob(RenderJob* job);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex mutex_;
+    std::condition_variable queue_changed_;
+    std::deque<std::shared_ptr<RenderJob>> queue_;
+    bool closed_ = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderPool)
+};
+
+// A render started by Synth.render_async. The worker fills in the audio or
+// the error, then hands the result to the job's event loop.
+struct AsyncRenderJob {
+  HeadlessSynth* synth = nullptr;
+  int midi_note = 0;
+  float velocity = 0.0f;
+  float note_dur = 0.0f;
+  float render_dur = 0.0f;
+
+  std::unique_ptr<float[]> audio;
+  int total_samples = 0;
+  std::string error;
+
+  // Python objects, only touched with the GIL held: the Synth, kept alive
+  // until its render is done, the event loop and the future to complete.
+  std::unique_ptr<nb::object> synth_object;
+  std::unique_ptr<nb::object> loop;
+  std::unique_ptr<nb::object> future;
+};
+
+// The native threads behind Synth.render_async, shared by every Synth in the
+// process. A job renders on its own Synth, so renders of different synths
+// overlap while renders of one synth queue on its lock. The GIL is only taken
+// once per job, to pass the finished audio to the event loop. The workers
+// start with the first job and stop at interpreter exit.
+class AsyncRenderer {
+  public:
+    // Queues a render and returns an asyncio future of the running event
+    // loop. Call with the GIL held, from the loop's thread.
+    static nb::object submit(HeadlessSynth& synth, int midi_note, float velocity, float note_dur, float render_dur);
+
+    // Renders everything already queued, then stops the workers. The next
+    // submit starts new ones. Registered with atexit.
+    static void shutdown();
+
+  private:
+    AsyncRenderer(int num_threads);
+
+    void run();
+    static void renderJob(AsyncRenderJob* job);
+    static void finishJob(std::unique_ptr<AsyncRenderJob> job);
+
+    static AsyncRenderer* instance_;
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable queue_changed_;
+    std::deque<std::unique_ptr<AsyncRenderJob>> queue_;
+    bool closed_ = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncRenderer)
+};
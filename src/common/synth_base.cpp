@@ -22,14 +22,182 @@
 #include "load_save.h"
 #include "memory.h"
 #include "modulation_connection_processor.h"
+#include "smooth_value.h"
 #include "startup.h"
 #include "synth_gui_interface.h"
 #include "synth_parameters.h"
 #include "utils.h"
+#include "value_switch.h"
 
 #include <iostream>
 #include <fstream>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+  // Block size and end-of-render fade shared by the numpy render paths.
+  constexpr int kRenderBufferSize = 64;
+  constexpr int kRenderFadeSamples = 200;
+
+  // Names accepted by setQuality and the oversampling each one fixes.
+  struct Quality {
+    const char* name;
+    int oversampling_amount;
+  };
+  constexpr Quality kQualities[] = { { "draft", 1 }, { "normal", 2 }, { "high", 4 } };
+
+  // Hands a planar (2, num_samples) buffer over to a numpy array. Constructing
+  // the capsule is the point of no return: if it succeeds it owns the buffer,
+  // so only release the unique_ptr afterwards. Call with the GIL held.
+  nb::ndarray<float, nb::shape<2, -1>, nb::numpy> planarArray(std::unique_ptr<float[]> data, int num_samples) {
+    nb::capsule owner(data.get(), [](void* p) noexcept { delete[] (float*)p; });
+    float* raw_data = data.release();
+    return nb::ndarray<float, nb::shape<2, -1>, nb::numpy>(raw_data, {2, static_cast<size_t>(num_samples)}, owner);
+  }
+
+  // A uniform value in [-0.5, 0.5) from a xorshift32 generator, cheap enough
+  // to run twice per sample.
+  force_inline float ditherUnit(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) * (1.0f / (1 << 24)) - 0.5f;
+  }
+
+  // Spreads a user's seed over the generator's state. xorshift32 never
+  // leaves zero, so that state is avoided.
+  force_inline uint32_t ditherState(uint32_t seed) {
+    uint32_t state = seed * 0x9e3779b9u + 0x6d2b79f5u;
+    return state ? state : 1u;
+  }
+
+  // Full scale maps to 32767. With a dither state, the sum of two uniform
+  // values gives triangular noise spanning one step either side.
+  force_inline int16_t toInt16(float sample, uint32_t* dither_state) {
+    float scaled = sample * 32767.0f;
+    if (dither_state)
+      scaled += ditherUnit(*dither_state) + ditherUnit(*dither_state);
+    long rounded = std::lrintf(vital::utils::clamp(scaled, -32768.0f, 32767.0f));
+    return static_cast<int16_t>(rounded);
+  }
+
+  // IEEE half precision bits, rounded to nearest even. Overflow goes to
+  // infinity and values below the smallest subnormal to zero.
+  force_inline uint16_t toFloat16(float sample) {
+    uint32_t bits;
+    std::memcpy(&bits, &sample, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t magnitude = bits & 0x7fffffff;
+
+    if (magnitude >= 0x47800000)
+      return sign | (magnitude > 0x7f800000 ? 0x7e00 : 0x7c00);
+
+    if (magnitude < 0x38800000) {
+      if (magnitude < 0x33000000)
+        return sign;
+
+      uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+      int shift = 126 - static_cast<int>(magnitude >> 23);
+      uint32_t half = mantissa >> shift;
+      uint32_t remainder = mantissa & ((1u << shift) - 1);
+      uint32_t halfway = 1u << (shift - 1);
+      if (remainder > halfway || (remainder == halfway && (half & 1)))
+        half++;
+      return sign | half;
+    }
+
+    uint32_t half = (magnitude - 0x38000000) >> 13;
+    uint32_t remainder = magnitude & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+      half++;
+    return sign | half;
+  }
+
+  // Copies a block of the engine's stereo output into planar or interleaved
+  // buffers of T, fading by t and converting each sample on the way.
+  template<typename T, typename Convert>
+  force_inline void writeFrames(void* left, void* right, int offset, int stride, const vital::mono_float* source,
+                                vital::mono_float t, int num_samples, Convert convert) {
+    T* left_samples = static_cast<T*>(left);
+    T* right_samples = static_cast<T*>(right);
+    for (int i = 0; i < num_samples; ++i) {
+      left_samples[(offset + i) * stride] = convert(t * source[vital::poly_float::kSize * i]);
+      right_samples[(offset + i) * stride] = convert(t * source[vital::poly_float::kSize * i + 1]);
+    }
+  }
+
+  // Audio files are written through a stream buffer this large, and in a
+  // single writeFromFloatArrays call per file.
+  constexpr int kFileBufferSize = 1 << 20;
+  // How many rendered files render_files lets queue up for the I/O thread.
+  constexpr size_t kMaxPendingFiles = 4;
+
+  bool isFlacFile(const File& file) {
+    return file.hasFileExtension(".flac");
+  }
+
+  // Raises for combinations the writers cannot produce, before any rendering.
+  void checkAudioFileFormat(const std::string& output_path, int bit_depth) {
+    if (bit_depth != 16 && bit_depth != 24 && bit_depth != 32)
+      throw std::invalid_argument("bit_depth must be 16, 24 or 32.");
+    if (isFlacFile(File(output_path)) && bit_depth == 32)
+      throw std::invalid_argument("FLAC files can only be 16 or 24 bit.");
+  }
+
+  bool writeAudioFile(const File& file, const float* left, const float* right, int num_samples,
+                      double sample_rate, int bit_depth) {
+    if (!file.hasWriteAccess())
+      return false;
+
+    file.deleteFile();
+    std::unique_ptr<FileOutputStream> stream = file.createOutputStream(kFileBufferSize);
+    if (stream == nullptr)
+      return false;
+
+    std::unique_ptr<AudioFormat> format;
+    if (isFlacFile(file))
+      format = std::make_unique<FlacAudioFormat>();
+    else
+      format = std::make_unique<WavAudioFormat>();
+
+    std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(stream.get(), sample_rate, 2,
+                                                                      bit_depth, {}, 0));
+    if (writer == nullptr)
+      return false;
+
+    // The writer owns the stream from here, and flushes it when destroyed.
+    stream.release();
+    const float* channels[] = { left, right };
+    return writer->writeFromFloatArrays(channels, 2, num_samples);
+  }
+
+  nb::dlpack::dtype sampleDtype(SynthBase::SampleFormat format) {
+    if (format == SynthBase::kInt16)
+      return nb::dtype<int16_t>();
+    if (format == SynthBase::kFloat16)
+      return { static_cast<uint8_t>(nb::dlpack::dtype_code::Float), 16, 1 };
+    return nb::dtype<float>();
+  }
+
+  // Sets a control without smoothing into the new value, so a render that
+  // starts right after doesn't depend on the value before.
+  void setControlHard(vital::Value* control, vital::mono_float value) {
+    if (vital::SmoothValue* smooth_value = dynamic_cast<vital::SmoothValue*>(control))
+      smooth_value->setHard(value);
+    else if (vital::cr::SmoothValue* cr_smooth_value = dynamic_cast<vital::cr::SmoothValue*>(control))
+      cr_smooth_value->setHard(value);
+    else
+      control->set(value);
+  }
+} // namespace
 
 SynthBase::SynthBase() : expired_(false) {
   expired_ = LoadSave::isExpired();
@@ -62,12 +230,160 @@ SynthBase::SynthBase() : expired_(false) {
   memory_index_ = 0;
 
   controls_ = engine_->getControls();
+  control_table_.resize(vital::Parameters::getNumParameters(), nullptr);
+  for (auto& control : controls_) {
+    int id = vital::Parameters::getIndex(control.first);
+    if (id >= 0)
+      control_table_[id] = control.second;
+  }
 
   Startup::doStartupChecks(midi_manager_.get());
 }
 
 SynthBase::~SynthBase() { }
 
+nb::ndarray<float, nb::shape<-1>, nb::numpy> SynthBase::getParameterVector(bool normalized) {
+  size_t num_parameters = control_table_.size();
+  std::unique_ptr<float[]> data(new float[std::max<size_t>(1, num_parameters)]);
+
+  {
+    nb::gil_scoped_release gil_release;
+    std::vector<float> values(num_parameters);
+    {
+      ScopedLock lock(getCriticalSection());
+      for (size_t i = 0; i < num_parameters; ++i) {
+        vital::Value* control = control_table_[i];
+        values[i] = control ? control->value() : vital::Parameters::getDetails(static_cast<int>(i))->default_value;
+      }
+    }
+
+    if (normalized)
+      vital::Parameters::getNormalizedFromValues(values.data(), data.get());
+    else
+      std::copy(values.begin(), values.end(), data.get());
+  }
+
+  nb::capsule owner(data.get(), [](void* p) noexcept { delete[] (float*)p; });
+  return nb::ndarray<float, nb::shape<-1>, nb::numpy>(data.release(), { num_parameters }, owner);
+}
+
+void SynthBase::setParameterVector(nb::ndarray<const float, nb::ndim<1>, nb::c_contig, nb::device::cpu> values,
+                                   bool normalized) {
+  size_t num_parameters = control_table_.size();
+  if (values.shape(0) != num_parameters) {
+    throw std::invalid_argument("Expected " + std::to_string(num_parameters) + " values, one per name in "
+                                "parameter_names(), got " + std::to_string(values.shape(0)) + ".");
+  }
+
+  // nanobind holds a reference to the array for the duration of the call.
+  nb::gil_scoped_release gil_release;
+  std::vector<float> plain(num_parameters);
+  if (normalized)
+    vital::Parameters::getValuesFromNormalized(values.data(), plain.data());
+  else
+    std::copy(values.data(), values.data() + num_parameters, plain.begin());
+
+  ScopedLock lock(getCriticalSection());
+  for (size_t i = 0; i < num_parameters; ++i) {
+    if (control_table_[i])
+      control_table_[i]->set(plain[i]);
+  }
+}
+
+namespace {
+  // Uniform in [0, 1) from the top 24 bits, so draws are the same on every
+  // platform, unlike std::uniform_real_distribution.
+  float randomUnit(std::mt19937_64& random) {
+    return static_cast<float>(random() >> 40) * (1.0f / (1 << 24));
+  }
+
+  std::vector<bool> matchControls(const std::vector<std::string>& patterns, bool empty_matches_all) {
+    int num_parameters = vital::Parameters::getNumParameters();
+    std::vector<bool> matches(num_parameters, empty_matches_all && patterns.empty());
+    for (const std::string& pattern : patterns) {
+      String wildcard(pattern);
+      bool found = false;
+      for (int i = 0; i < num_parameters; ++i) {
+        if (String(vital::Parameters::getDetails(i)->name).matchesWildcard(wildcard, false)) {
+          matches[i] = true;
+          found = true;
+        }
+      }
+      if (!found)
+        throw std::invalid_argument("No control matches " + pattern + ".");
+    }
+    return matches;
+  }
+} // namespace
+
+void SynthBase::randomize(uint64_t seed, const std::vector<std::string>& include,
+                          const std::vector<std::string>& exclude, const std::string& distribution,
+                          int num_modulations) {
+  bool normalized = distribution == "uniform_normalized";
+  if (!normalized && distribution != "uniform")
+    throw std::invalid_argument("distribution must be \"uniform_normalized\" or \"uniform\".");
+  if (num_modulations < 0 || num_modulations > vital::kMaxModulationConnections) {
+    throw std::invalid_argument("modulations must be between 0 and " +
+                                std::to_string(vital::kMaxModulationConnections) + ".");
+  }
+
+  std::vector<bool> included = matchControls(include, true);
+  std::vector<bool> excluded = matchControls(exclude, false);
+
+  nb::gil_scoped_release gil_release;
+  std::mt19937_64 random(seed);
+  std::vector<std::pair<vital::Value*, vital::mono_float>> changes;
+  for (int i = 0; i < static_cast<int>(control_table_.size()); ++i) {
+    if (control_table_[i] == nullptr || !included[i] || excluded[i])
+      continue;
+
+    const vital::ValueDetails& details = *vital::Parameters::getDetails(i);
+    float unit = randomUnit(random);
+    vital::mono_float value;
+    if (details.value_scale == vital::ValueDetails::kIndexed)
+      value = std::min(details.max, details.min + std::floor(unit * (details.max - details.min + 1.0f)));
+    else if (normalized)
+      value = vital::Parameters::getValueFromNormalized(details, unit);
+    else
+      value = details.min + unit * (details.max - details.min);
+    changes.emplace_back(control_table_[i], value);
+  }
+
+  ScopedLock lock(getCriticalSection());
+  for (auto& change : changes)
+    change.first->set(change.second);
+
+  if (num_modulations == 0)
+    return;
+
+  std::vector<std::string> sources;
+  for (auto& source : engine_->getModulationSources())
+    sources.push_back(source.first);
+  std::vector<std::string> destinations;
+  for (auto& destination : engine_->getMonoModulationDestinations())
+    destinations.push_back(destination.first);
+
+  clearModulations();
+  int connected = 0;
+  int max_attempts = 8 * num_modulations;
+  for (int attempt = 0; attempt < max_attempts && connected < num_modulations; ++attempt) {
+    const std::string& source = sources[random() % sources.size()];
+    const std::string& destination = destinations[random() % destinations.size()];
+    if (getConnection(source, destination))
+      continue;
+
+    connectModulation(source, destination);
+    int index = getConnectionIndex(source, destination);
+    if (index < 0)
+      continue;
+
+    std::string amount_name = "modulation_" + std::to_string(index + 1) + "_amount";
+    const vital::ValueDetails& details = vital::Parameters::getDetails(amount_name);
+    controls_[amount_name]->set(vital::Parameters::getValueFromNormalized(details, randomUnit(random)));
+    connected++;
+  }
+}
+
 void SynthBase::valueChanged(const std::string& name, vital::mono_float value) {
   controls_[name]->set(value);
 }
@@ -320,6 +636,34 @@ json SynthBase::saveToJson() {
   return LoadSave::stateToJson(this, getCriticalSection());
 }
 
+MemoryBlock SynthBase::saveToBinary() {
+  ScopedLock lock(getCriticalSection());
+  return LoadSave::stateToBinary(this, getCriticalSection());
+}
+
+bool SynthBase::loadFromBinary(const void* data, size_t size) {
+  // Read the whole state before touching anything, so a bad one leaves this
+  // synth as it was.
+  std::unique_ptr<LoadSave::BinaryState> state;
+  try {
+    state = LoadSave::parseBinaryState(this, data, size);
+  }
+  catch (const json::exception& e) {
+    return false;
+  }
+  catch (const std::out_of_range& e) {
+    return false;
+  }
+  if (state == nullptr)
+    return false;
+
+  ScopedProcessingPause pause(this);
+  engine_->allSoundsOff();
+  invalidateRenders();
+  LoadSave::applyBinaryState(this, save_info_, *state);
+  return true;
+}
+
 int SynthBase::getSampleRate() {
   return engine_->getSampleRate();
 }
@@ -353,6 +697,7 @@ void SynthBase::loadTuningFile(const File& file) {
 void SynthBase::loadInitPreset() {
   ScopedProcessingPause pause(this);
   engine_->allSoundsOff();
+  invalidateRenders();
   initEngine();
   LoadSave::initSaveInfo(save_info_);
 }
@@ -366,9 +711,65 @@ bool SynthBase::loadFromJson(const json& data) {
   // uninterruptible hang rather than a Python-level error.
   ScopedProcessingPause pause(this);
   engine_->allSoundsOff();
+  // LFO shapes and wavetables are not controls, so a new preset with matching
+  // control values would still slip past the render settings check.
+  invalidateRenders();
   return LoadSave::jsonToState(this, save_info_, data);
 }
 
+void SynthBase::copyStateFrom(SynthBase* source) {
+  ScopedProcessingPause pause(this);
+  engine_->allSoundsOff();
+  invalidateRenders();
+
+  if (getSampleRate() != source->getSampleRate())
+    setSampleRate(source->getSampleRate());
+  engine_->setOversamplingOverride(source->engine_->getOversamplingOverride());
+
+  // Both synths build their control tables from the same parameter list.
+  VITAL_ASSERT(control_table_.size() == source->control_table_.size());
+  for (size_t i = 0; i < control_table_.size(); ++i) {
+    if (control_table_[i])
+      control_table_[i]->set(source->control_table_[i]->value());
+  }
+  modWheelGuiChanged(controls_["mod_wheel"]->value());
+
+  clearModulations();
+  vital::ModulationConnectionBank& modulation_bank = getModulationBank();
+  vital::ModulationConnectionBank& source_bank = source->getModulationBank();
+  for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
+    vital::ModulationConnection* source_connection = source_bank.atIndex(i);
+    vital::ModulationConnection* connection = modulation_bank.atIndex(i);
+    if (!source_connection->source_name.empty() && !source_connection->destination_name.empty()) {
+      connection->source_name = source_connection->source_name;
+      connection->destination_name = source_connection->destination_name;
+      connectModulation(connection);
+    }
+
+    LineGenerator* source_mapping = source_connection->modulation_processor->lineMapGenerator();
+    connection->modulation_processor->lineMapGenerator()->copy(source_mapping);
+  }
+
+  vital::Sample* sample = getSample();
+  if (sample)
+    sample->copy(source->getSample());
+
+  for (int i = 0; i < vital::kNumOscillators; ++i) {
+    if (wavetable_creators_[i])
+      wavetable_creators_[i]->copy(source->getWavetableCreator(i));
+  }
+
+  for (int i = 0; i < vital::kNumLfos; ++i)
+    getLfoSource(i)->copy(source->getLfoSource(i));
+
+  // The engine reads the tuning through a pointer, so copy it in place.
+  tuning_ = source->tuning_;
+  midi_manager_->setMpeEnabled(source->midi_manager_->isMpeEnabled());
+
+  save_info_ = source->save_info_;
+  checkOversampling();
+}
+
 bool SynthBase::loadFromFile(File preset, std::string& error) {
   if (!preset.exists())
     return false;
@@ -451,6 +852,33 @@ void SynthBase::setSampleRate(double sample_rate) {
   midi_manager_->setSampleRate(sample_rate);
 }
 
+void SynthBase::setQuality(const std::optional<std::string>& quality) {
+  int oversampling_amount = 0;
+  if (quality) {
+    auto found = std::find_if(std::begin(kQualities), std::end(kQualities),
+                              [&](const Quality& q) { return *quality == q.name; });
+    if (found == std::end(kQualities))
+      throw std::invalid_argument("Unknown quality " + *quality + ", expected draft, normal or high.");
+    oversampling_amount = found->oversampling_amount;
+  }
+
+  ScopedProcessingPause pause(this);
+  engine_->allSoundsOff();
+  invalidateRenders();
+  engine_->setOversamplingOverride(oversampling_amount);
+  checkOversampling();
+}
+
+std::optional<std::string> SynthBase::getQuality() {
+  ScopedLock lock(getCriticalSection());
+  int oversampling_amount = engine_->getOversamplingOverride();
+  for (const Quality& quality : kQualities) {
+    if (quality.oversampling_amount == oversampling_amount)
+      return std::string(quality.name);
+  }
+  return std::nullopt;
+}
+
 void SynthBase::renderAudioToFile(File file, std::vector<int> notes, float velocity, float note_dur, float render_dur, bool render_images) {
   static constexpr int kPreProcessSamples = 44100;
   static constexpr int kFadeSamples = 200;
@@ -471,13 +899,7 @@ void SynthBase::renderAudioToFile(File file, std::vector<int> notes, float veloc
   int kSampleRate = getSampleRate();
 
   double sample_time = 1.0 / kSampleRate;
-  double current_time = -kPreProcessSamples * sample_time;
-
-  for (int samples = 0; samples < kPreProcessSamples; samples += kBufferSize) {
-    engine_->correctToTime(current_time);
-    current_time += kBufferSize * sample_time;
-    engine_->process(kBufferSize);
-  }
+  double current_time = warmUpForRender(kPreProcessSamples);
 
   for (int note : notes)
     engine_->noteOn(note, velocity, 0, 0);
@@ -576,17 +998,264 @@ void SynthBase::renderAudioToFile(File file, std::vector<int> notes, float veloc
   file_stream.release();
 }
 
-nb::ndarray<float, nb::shape<2, -1>, nb::numpy> SynthBase::renderAudioToNumpy(const int& midi_note, float velocity, float note_dur, float render_dur) {
-  static constexpr int kFadeSamples = 200;
-  static constexpr int kBufferSize = 64;
-  static constexpr int kPreProcessSamples = 256; // note: dbraun decreased this from 44100.
+double SynthBase::warmUpForRender(int pre_process_samples) {
+  engine_->allSoundsOff();  // note: dbraun added this
+  // Every render starts on the same voice so it doesn't depend on what was rendered before.
+  engine_->resetVoiceAllocation();
+
+  if (render_snapshot_ && render_snapshot_->load_generation_ == load_generation_ &&
+      renderSettingsMatch(render_snapshot_->settings_)) {
+    if (render_snapshot_->state_.restore(engine_.get()))
+      return render_snapshot_->start_time_;
+    render_snapshot_ = nullptr;
+  }
+
+  // Preprocess modulation
+  double sample_time = 1.0 / getSampleRate();
+  double current_time = -pre_process_samples * sample_time;
+
+  for (int samples = 0; samples < pre_process_samples; samples += kRenderBufferSize) {
+    engine_->correctToTime(current_time);
+    current_time += kRenderBufferSize * sample_time;
+    engine_->process(kRenderBufferSize);
+  }
+
+  return current_time;
+}
+
+SynthBase::RenderSettings SynthBase::captureRenderSettings() {
+  RenderSettings settings;
+  settings.sample_rate = getSampleRate();
+  settings.control_values.reserve(control_table_.size());
+  for (vital::Value* control : control_table_)
+    settings.control_values.push_back(control ? control->value() : 0.0f);
+  for (vital::ModulationConnection* connection : mod_connections_)
+    settings.connections.push_back(connection);
+  return settings;
+}
+
+bool SynthBase::renderSettingsMatch(const RenderSettings& settings) {
+  if (settings.sample_rate != getSampleRate() ||
+      settings.control_values.size() != control_table_.size() ||
+      settings.connections.size() != static_cast<size_t>(mod_connections_.size())) {
+    return false;
+  }
+
+  for (size_t i = 0; i < control_table_.size(); ++i) {
+    if (control_table_[i] && control_table_[i]->value() != settings.control_values[i])
+      return false;
+  }
+
+  int index = 0;
+  for (vital::ModulationConnection* connection : mod_connections_) {
+    if (connection != settings.connections[index++])
+      return false;
+  }
+  return true;
+}
+
+void SynthBase::invalidateRenders() {
+  ++render_generation_;
+  ++load_generation_;
+  render_snapshot_ = nullptr;
+}
+
+std::shared_ptr<RenderSnapshot> SynthBase::takeRenderSnapshot(int warmup_samples) {
+  if (warmup_samples < 0)
+    throw std::invalid_argument("warmup_samples must not be negative.");
+
+  std::shared_ptr<RenderSnapshot> snapshot(new RenderSnapshot(this, warmup_samples));
+
+  nb::gil_scoped_release gil_release;
+  ScopedLock lock(getCriticalSection());
+
+  processModulationChanges();
+  engine_->updateAllModulationSwitches();
+  render_snapshot_ = nullptr;
+  snapshot->start_time_ = warmUpForRender(warmup_samples);
+  snapshot->load_generation_ = load_generation_;
+  snapshot->settings_ = captureRenderSettings();
+  snapshot->state_.save(engine_.get());
+
+  ++render_generation_;
+  render_snapshot_ = snapshot;
+  return snapshot;
+}
+
+void SynthBase::restoreRenderSnapshot(const std::shared_ptr<RenderSnapshot>& snapshot) {
+  if (snapshot == nullptr || snapshot->synth_ != this)
+    throw std::invalid_argument("The snapshot was taken on a different Synth.");
+
+  nb::gil_scoped_release gil_release;
+  ScopedLock lock(getCriticalSection());
+
+  if (snapshot->load_generation_ != load_generation_)
+    throw std::runtime_error("A preset was loaded or the quality changed since the snapshot was taken.");
+
+  processModulationChanges();
+  engine_->updateAllModulationSwitches();
+  // Restoring puts control values back, but connections live outside the
+  // processor state, so they have to be the ones the snapshot was taken with.
+  RenderSettings settings = captureRenderSettings();
+  if (settings.connections != snapshot->settings_.connections)
+    throw std::runtime_error("The modulations changed since the snapshot was taken.");
+  if (!snapshot->state_.restore(engine_.get()))
+    throw std::runtime_error("The wavetables, sample rate or oversampling changed since the snapshot was taken.");
+
+  ++render_generation_;
+  render_snapshot_ = snapshot;
+}
+
+void SynthBase::clearRenderSnapshot() {
+  ScopedLock lock(getCriticalSection());
+  render_snapshot_ = nullptr;
+}
+
+void SynthBase::startNoteRender(NoteRender& render, int midi_note, float velocity, float note_dur,
+                                int total_samples) {
+  double current_time = warmUpForRender();
+  engine_->noteOn(midi_note, velocity, 0, 0);
+
+  render.midi_note = midi_note;
+  render.on_samples = note_dur * getSampleRate();
+  render.total_samples = total_samples;
+  render.position = 0;
+  render.current_time = current_time;
+  render.generation = ++render_generation_;
+}
+
+void SynthBase::continueNoteRender(NoteRender& render, int num_samples, void* left, void* right, int stride) {
+  VITAL_ASSERT(render.generation == render_generation_);
+  VITAL_ASSERT(render.position % kRenderBufferSize == 0);
+
+  double sample_time = 1.0 / getSampleRate();
+  int end = std::min(render.total_samples, render.position + num_samples);
+  const vital::mono_float* engine_output = (const vital::mono_float*)engine_->output(0)->buffer;
+
+  for (int samples = render.position; samples < end; samples += kRenderBufferSize) {
+    engine_->correctToTime(render.current_time);
+    render.current_time += kRenderBufferSize * sample_time;
+    engine_->process(kRenderBufferSize);
+    updateMemoryOutput(kRenderBufferSize, engine_->output(0)->buffer);
+
+    if (render.on_samples > samples && render.on_samples <= samples + kRenderBufferSize)
+      engine_->noteOff(render.midi_note, 0.5f, 0, 0);
+
+    vital::mono_float t = (render.total_samples - samples) / (1.0f * kRenderFadeSamples);
+    t = vital::utils::min(t, 1.0f);
+    int block_samples = std::min(kRenderBufferSize, end - samples);
+    int offset = samples - render.position;
+    if (render.format == kInt16) {
+      uint32_t* dither_state = render.dither_state ? &render.dither_state : nullptr;
+      writeFrames<int16_t>(left, right, offset, stride, engine_output, t, block_samples,
+                           [dither_state](float sample) { return toInt16(sample, dither_state); });
+    }
+    else if (render.format == kFloat16)
+      writeFrames<uint16_t>(left, right, offset, stride, engine_output, t, block_samples, toFloat16);
+    else
+      writeFrames<float>(left, right, offset, stride, engine_output, t, block_samples, [](float sample) { return sample; });
+
+    if (render.capture_data) {
+      int block = samples / kRenderBufferSize;
+      for (size_t c = 0; c < render.captures->size(); ++c) {
+        vital::poly_float value = readCaptureSource((*render.captures)[c]);
+        float* destination = render.capture_data + 2 * (c * render.capture_blocks + block);
+        destination[0] = value[0];
+        destination[1] = value[1];
+      }
+    }
+
+    if (render.stem_data) {
+      for (size_t s = 0; s < render.stem_ids->size(); ++s) {
+        int stem = (*render.stem_ids)[s];
+        if (stem < 0)
+          continue;
+
+        const vital::mono_float* stem_output = (const vital::mono_float*)engine_->getStemOutput(stem)->buffer;
+        float* stem_left = render.stem_data + 2 * s * render.total_samples + samples;
+        float* stem_right = stem_left + render.total_samples;
+        for (int i = 0; i < block_samples; ++i) {
+          stem_left[i] = t * stem_output[vital::poly_float::kSize * i];
+          stem_right[i] = t * stem_output[vital::poly_float::kSize * i + 1];
+        }
+      }
+    }
+
+    // Once the note is released, stop as soon as the output has stayed under
+    // the threshold for the hold time. Whatever remains would be silence.
+    if (render.trim.threshold > 0.0f && samples >= render.on_samples) {
+      vital::poly_float peak = vital::utils::peak(engine_->output(0)->buffer, block_samples);
+      if (std::max(peak[0], peak[1]) < render.trim.threshold)
+        render.silent_samples += block_samples;
+      else
+        render.silent_samples = 0;
+
+      if (render.silent_samples >= render.trim.hold_samples) {
+        end = samples + block_samples;
+        render.total_samples = end;
+        break;
+      }
+    }
+  }
+
+  render.position = end;
+}
+
+int SynthBase::renderNoteToBuffers(int midi_note, float velocity, float note_dur, int total_samples,
+                                   float* left, float* right, int stride, const TailTrim& trim) {
+  NoteRender render;
+  startNoteRender(render, midi_note, velocity, note_dur, total_samples);
+  render.trim = trim;
+  continueNoteRender(render, total_samples, left, right, stride);
+  return render.total_samples;
+}
+
+SynthBase::TailTrim SynthBase::makeTailTrim(bool trim_tail, float threshold_db, float hold_seconds) {
+  TailTrim trim;
+  if (trim_tail) {
+    trim.threshold = vital::utils::dbToMagnitude(threshold_db);
+    trim.hold_samples = std::max(1, static_cast<int>(hold_seconds * getSampleRate()));
+  }
+  return trim;
+}
+
+SynthBase::SampleFormat SynthBase::sampleFormatFromName(const std::string& name) {
+  if (name == "float32")
+    return kFloat32;
+  if (name == "int16")
+    return kInt16;
+  if (name == "float16")
+    return kFloat16;
+  throw std::invalid_argument("Unsupported dtype " + name + ", expected float32, int16 or float16.");
+}
+
+void SynthBase::renderNoteToMemory(int midi_note, float velocity, float note_dur, int total_samples,
+                                   void* left, void* right, SampleFormat format) {
+  ScopedLock lock(getCriticalSection());
+  processModulationChanges();
+  engine_->updateAllModulationSwitches();
+
+  NoteRender render;
+  startNoteRender(render, midi_note, velocity, note_dur, total_samples);
+  render.format = format;
+  continueNoteRender(render, total_samples, left, right, 1);
+}
+
+nb::ndarray<nb::numpy, nb::shape<2, -1>> SynthBase::renderAudioToNumpy(const int& midi_note, float velocity,
+                                                                       float note_dur, float render_dur,
+                                                                       bool trim_tail, float tail_threshold_db,
+                                                                       float tail_hold, SampleFormat format,
+                                                                       bool dither, uint32_t dither_seed) {
+  if (dither && format != kInt16)
+    throw std::invalid_argument("dither is only supported for int16 output.");
 
   // These are populated by the GIL-released DSP region below and consumed
   // afterward (with the GIL held) to build the returned numpy array. The buffer
   // is owned by a unique_ptr for the duration of the render so that an exception
   // unwinding out of the DSP loop frees it; ownership is handed to the capsule
   // below only once we are sure we can return.
-  std::unique_ptr<float[]> data;
+  size_t sample_size = format == kFloat32 ? sizeof(float) : sizeof(uint16_t);
+  std::unique_ptr<uint8_t[]> data;
   int total_samples = 0;
 
   {
@@ -603,82 +1272,632 @@ nb::ndarray<float, nb::shape<2, -1>, nb::numpy> SynthBase::renderAudioToNumpy(co
 
     ScopedLock lock(getCriticalSection());
 
-    engine_->allSoundsOff();  // note: dbraun added this
-
     processModulationChanges();
     engine_->updateAllModulationSwitches();
-    int kSampleRate = getSampleRate();
 
-    // Preprocess modulation
-    double sample_time = 1.0 / kSampleRate;
-    double current_time = -kPreProcessSamples * sample_time;
+    total_samples = std::max(0, static_cast<int>(render_dur * getSampleRate()));
+    size_t total_frames =
+        static_cast<size_t>(total_samples * 2);  // stereo: 2 channels
 
-    for (int samples = 0; samples < kPreProcessSamples; samples += kBufferSize) {
-      engine_->correctToTime(current_time);
-      current_time += kBufferSize * sample_time;
-      engine_->process(kBufferSize);
+    // Every sample is written below, so skip the zero fill.
+    data.reset(new uint8_t[std::max<size_t>(1, total_frames) * sample_size]);
+    NoteRender render;
+    startNoteRender(render, midi_note, velocity, note_dur, total_samples);
+    render.trim = makeTailTrim(trim_tail, tail_threshold_db, tail_hold);
+    render.format = format;
+    if (dither)
+      render.dither_state = ditherState(dither_seed);
+    continueNoteRender(render, total_samples, data.get(), data.get() + total_samples * sample_size, 1);
+    int rendered = render.total_samples;
+
+    // A trimmed render keeps its allocation; just close the gap between the
+    // channels so the array stays contiguous.
+    if (rendered < total_samples) {
+      std::memmove(data.get() + rendered * sample_size, data.get() + total_samples * sample_size,
+                   rendered * sample_size);
+      total_samples = rendered;
     }
+  }
+  // GIL re-acquired here (RAII) before any Python interaction below.
 
-    engine_->noteOn(midi_note, velocity, 0, 0);
+  nb::capsule owner(data.get(), [](void* p) noexcept { delete[] (uint8_t*)p; });
+  uint8_t* raw_data = data.release();
+  return nb::ndarray<nb::numpy, nb::shape<2, -1>>(raw_data, {2, static_cast<size_t>(total_samples)}, owner, {},
+                                                  sampleDtype(format));
+}
 
-    int on_samples = note_dur * kSampleRate;
-    total_samples = render_dur * kSampleRate;
-    const vital::mono_float* engine_output =
-        (const vital::mono_float*)engine_->output(0)->buffer;
+SynthBase::CaptureSource SynthBase::makeCaptureSource(const std::string& name) {
+  CaptureSource source;
+  source.status = engine_->getStatusOutput(name);
+  if (source.status)
+    return source;
 
-    size_t total_frames =
-        static_cast<size_t>(total_samples * 2);  // stereo: 2 channels
+  vital::output_map& mono_readouts = engine_->getMonoModulations();
+  auto mono = mono_readouts.find(name);
+  if (mono == mono_readouts.end() || controls_.count(name) == 0)
+    throw std::invalid_argument("Nothing to capture named " + name + ".");
+
+  source.base = controls_[name];
+  source.mono_switch = engine_->getMonoModulationSwitch(name);
+  source.mono = mono->second;
+
+  // The voice handler only copies out a destination's polyphonic readout
+  // while a polyphonic source modulates it.
+  for (vital::ModulationConnection* connection : mod_connections_) {
+    if (connection->destination_name != name)
+      continue;
+
+    vital::modulation_change change = createModulationChange(connection);
+    if (change.poly_destination && change.source->owner->isPolyphonic()) {
+      vital::output_map& poly_readouts = engine_->getPolyModulations();
+      auto poly = poly_readouts.find(name);
+      if (poly != poly_readouts.end())
+        source.poly = poly->second;
+      break;
+    }
+  }
+  return source;
+}
 
-    data = std::make_unique<float[]>(total_frames);  // Zero-initialized
+vital::poly_float SynthBase::readCaptureSource(const CaptureSource& source) {
+  // Per-voice status outputs are cleared once no voice is playing.
+  if (source.status) {
+    vital::poly_float value = source.status->value();
+    if (source.status->isClearValue(value))
+      return std::numeric_limits<float>::quiet_NaN();
+    return value;
+  }
 
-    int baseSample = 0;
+  vital::poly_float value = source.base->value();
+  if (source.mono_switch && source.mono_switch->value())
+    value = source.mono->buffer[0];
+  if (source.poly)
+    value += source.poly->buffer[0];
+  return value;
+}
+
+nb::object SynthBase::renderTappedToNumpy(int midi_note, float velocity, float note_dur, float render_dur,
+                                          const std::optional<std::vector<std::string>>& stems,
+                                          const std::vector<std::string>& capture) {
+  static constexpr int kMixStem = -1;
+  std::map<std::string, int> stem_lookup = {
+    { "sample", vital::SoundEngine::kSampleStem },
+    { "dry", vital::SoundEngine::kDryStem },
+    { "wet", vital::SoundEngine::kWetStem },
+    { "mix", kMixStem }
+  };
+  for (int i = 0; i < vital::kNumOscillators; ++i)
+    stem_lookup["osc_" + std::to_string(i + 1)] = i;
+
+  std::vector<int> stem_ids;
+  if (stems) {
+    if (stems->empty())
+      throw std::invalid_argument("stems must not be empty.");
+    for (const std::string& stem : *stems) {
+      auto id = stem_lookup.find(stem);
+      if (id == stem_lookup.end())
+        throw std::invalid_argument("Unknown stem " + stem + ".");
+      stem_ids.push_back(id->second);
+    }
+  }
+  bool use_stems = std::any_of(stem_ids.begin(), stem_ids.end(), [](int id) { return id != kMixStem; });
+
+  std::unique_ptr<float[]> data;
+  std::unique_ptr<float[]> capture_data;
+  size_t num_items = stems ? stem_ids.size() : 1;
+  int total_samples = 0;
+  int num_blocks = 0;
+  {
+    nb::gil_scoped_release gil_release;
+    ScopedLock lock(getCriticalSection());
+
+    processModulationChanges();
+    engine_->updateAllModulationSwitches();
 
-    for (int samples = 0; samples < total_samples; samples += kBufferSize) {
-      engine_->correctToTime(current_time);
-      current_time += kBufferSize * sample_time;
-      engine_->process(kBufferSize);
-      updateMemoryOutput(kBufferSize, engine_->output(0)->buffer);
+    std::vector<CaptureSource> captures;
+    for (const std::string& name : capture)
+      captures.push_back(makeCaptureSource(name));
+
+    total_samples = std::max(0, static_cast<int>(render_dur * getSampleRate()));
+    num_blocks = (total_samples + kRenderBufferSize - 1) / kRenderBufferSize;
+    size_t item_frames = static_cast<size_t>(total_samples) * 2;
+    data.reset(new float[std::max<size_t>(1, num_items * item_frames)]);
+    capture_data.reset(new float[std::max<size_t>(1, captures.size() * num_blocks * 2)]);
+
+    std::unique_ptr<float[]> mix;
+    float* mix_data = data.get();
+    if (stems) {
+      mix.reset(new float[std::max<size_t>(1, item_frames)]);
+      mix_data = mix.get();
+    }
 
-      if (on_samples > samples && on_samples <= samples + kBufferSize) {
-        engine_->noteOff(midi_note, 0.5f, 0, 0);
+    // The stem processors only run for the length of this render.
+    struct ScopedStems {
+      ScopedStems(vital::SoundEngine* engine, bool enable) : engine(enable ? engine : nullptr) {
+        if (this->engine)
+          this->engine->enableStems(true);
       }
+      ~ScopedStems() {
+        if (engine)
+          engine->enableStems(false);
+      }
+      vital::SoundEngine* engine;
+    } scoped_stems(engine_.get(), use_stems);
+
+    NoteRender render;
+    startNoteRender(render, midi_note, velocity, note_dur, total_samples);
+    if (use_stems) {
+      render.stem_ids = &stem_ids;
+      render.stem_data = data.get();
+    }
+    if (!captures.empty()) {
+      render.captures = &captures;
+      render.capture_data = capture_data.get();
+      render.capture_blocks = num_blocks;
+    }
+    continueNoteRender(render, total_samples, mix_data, mix_data + total_samples, 1);
 
-      for (int i = 0; i < kBufferSize; ++i) {
-        vital::mono_float t = (total_samples - samples) / (1.0f * kFadeSamples);
-        t = vital::utils::min(t, 1.0f);
-        baseSample = samples + i;
-        if (baseSample < total_samples) {
-          data[samples + i] = t * engine_output[vital::poly_float::kSize * i];
-          data[samples + i + total_samples] =
-              t * engine_output[vital::poly_float::kSize * i + 1];
+    for (size_t s = 0; s < stem_ids.size(); ++s) {
+      if (stem_ids[s] == kMixStem)
+        std::copy(mix_data, mix_data + item_frames, data.get() + s * item_frames);
+    }
+  }
+
+  nb::object audio;
+  if (stems) {
+    nb::capsule owner(data.get(), [](void* p) noexcept { delete[] (float*)p; });
+    float* raw_data = data.release();
+    audio = nb::cast(nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy>(
+        raw_data, { num_items, 2, static_cast<size_t>(total_samples) }, owner));
+  }
+  else
+    audio = nb::cast(planarArray(std::move(data), total_samples));
+
+  if (capture.empty())
+    return audio;
+
+  // Every capture is a view into one buffer, which the capsule frees once
+  // the last of them is gone.
+  nb::capsule capture_owner(capture_data.get(), [](void* p) noexcept { delete[] (float*)p; });
+  float* raw_captures = capture_data.release();
+  nb::dict captured;
+  for (size_t i = 0; i < capture.size(); ++i) {
+    captured[capture[i].c_str()] = nb::ndarray<float, nb::shape<-1, 2>, nb::numpy>(
+        raw_captures + i * num_blocks * 2, { static_cast<size_t>(num_blocks), 2 }, capture_owner);
+  }
+  return nb::make_tuple(audio, captured);
+}
+
+std::unique_ptr<float[]> SynthBase::renderBatchToBuffer(const std::vector<int>& midi_notes,
+                                                         const std::vector<float>& velocities,
+                                                         const std::vector<float>& note_durs, float render_dur,
+                                                         bool trim_tail, float tail_threshold_db, float tail_hold,
+                                                         int& total_samples) {
+  // Same locking discipline as renderAudioToNumpy, but taken once for the whole
+  // batch: the modulation changes and switches are flushed once, and every
+  // note renders straight into its slice of one allocation.
+  ScopedLock lock(getCriticalSection());
+
+  processModulationChanges();
+  engine_->updateAllModulationSwitches();
+
+  size_t num_notes = midi_notes.size();
+  total_samples = std::max(0, static_cast<int>(render_dur * getSampleRate()));
+  size_t item_frames = static_cast<size_t>(total_samples) * 2;
+
+  // Every sample of every item is written below, so skip the zero fill.
+  std::unique_ptr<float[]> data(new float[std::max<size_t>(1, num_notes * item_frames)]);
+  TailTrim trim = makeTailTrim(trim_tail, tail_threshold_db, tail_hold);
+  for (size_t i = 0; i < num_notes; ++i) {
+    float velocity = velocities[velocities.size() == 1 ? 0 : i];
+    float note_dur = note_durs[note_durs.size() == 1 ? 0 : i];
+    float* left = data.get() + i * item_frames;
+    float* right = left + total_samples;
+    int rendered = renderNoteToBuffers(midi_notes[i], velocity, note_dur, total_samples, left, right, 1, trim);
+
+    // Items share one shape, so a trimmed item is padded with silence.
+    std::fill(left + rendered, left + total_samples, 0.0f);
+    std::fill(right + rendered, right + total_samples, 0.0f);
+  }
+
+  return data;
+}
+
+nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy> SynthBase::renderBatchToNumpy(
+    const std::vector<int>& midi_notes, const std::vector<float>& velocities,
+    const std::vector<float>& note_durs, float render_dur,
+    bool trim_tail, float tail_threshold_db, float tail_hold) {
+  // A single velocity or note length applies to every note; otherwise there
+  // must be one per note. Checked before the GIL is released so the error
+  // reaches Python as a plain ValueError.
+  size_t num_notes = midi_notes.size();
+  if (velocities.size() != 1 && velocities.size() != num_notes)
+    throw std::invalid_argument("velocities must have one entry or one per note.");
+  if (note_durs.size() != 1 && note_durs.size() != num_notes)
+    throw std::invalid_argument("note_durs must have one entry or one per note.");
+
+  std::unique_ptr<float[]> data;
+  int total_samples = 0;
+
+  {
+    nb::gil_scoped_release gil_release;
+    data = renderBatchToBuffer(midi_notes, velocities, note_durs, render_dur,
+                               trim_tail, tail_threshold_db, tail_hold, total_samples);
+  }
+
+  nb::capsule owner(data.get(), [](void* p) noexcept { delete[] (float*)p; });
+  float* raw_data = data.release();
+
+  return nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy>(
+      raw_data, {num_notes, 2, static_cast<size_t>(total_samples)}, owner);
+}
+
+void SynthBase::renderSweepPoints(const std::vector<vital::Value*>& controls, const float* values, int points,
+                                  int midi_note, float velocity, float note_dur, int total_samples,
+                                  float* output) {
+  processModulationChanges();
+
+  size_t num_controls = controls.size();
+  size_t item_frames = static_cast<size_t>(total_samples) * 2;
+  for (int point = 0; point < points; ++point) {
+    // Smoothing in from the previous point's values would make each point
+    // depend on its neighbour in the grid, and on which thread rendered it.
+    for (size_t c = 0; c < num_controls; ++c)
+      setControlHard(controls[c], values[point * num_controls + c]);
+    engine_->updateAllModulationSwitches();
+    engine_->checkOversampling();
+
+    float* left = output + point * item_frames;
+    renderNoteToBuffers(midi_note, velocity, note_dur, total_samples, left, left + total_samples, 1, TailTrim());
+  }
+}
+
+nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy> SynthBase::renderSweepToNumpy(
+    const std::vector<std::string>& control_names,
+    nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> value_grid,
+    int midi_note, float velocity, float note_dur, float render_dur, int num_threads) {
+  size_t num_controls = control_names.size();
+  if (value_grid.shape(1) != num_controls)
+    throw std::invalid_argument("value_grid must have one column per control.");
+  if (num_threads <= 0)
+    throw std::invalid_argument("num_threads must be positive.");
+  std::vector<int> control_ids;
+  for (const std::string& name : control_names) {
+    int id = vital::Parameters::getIndex(name);
+    if (id < 0 || control_table_[id] == nullptr)
+      throw std::invalid_argument("No control named " + name + ".");
+    control_ids.push_back(id);
+  }
+
+  int points = static_cast<int>(value_grid.shape(0));
+  std::vector<float> values(value_grid.data(), value_grid.data() + points * num_controls);
+  std::unique_ptr<float[]> data;
+  int total_samples = 0;
+
+  {
+    nb::gil_scoped_release gil_release;
+    ScopedLock lock(getCriticalSection());
+
+    total_samples = std::max(0, static_cast<int>(render_dur * getSampleRate()));
+    size_t item_frames = static_cast<size_t>(total_samples) * 2;
+    data.reset(new float[std::max<size_t>(1, points * item_frames)]);
+
+    std::vector<vital::Value*> controls;
+    std::vector<vital::mono_float> original_values;
+    for (int id : control_ids) {
+      controls.push_back(control_table_[id]);
+      original_values.push_back(control_table_[id]->value());
+    }
+
+    // Each extra thread renders a contiguous share of the grid on a copy of
+    // this synth; this one renders the first share itself. The copies are
+    // made before any thread starts so a failed copy leaves none to join.
+    int num_shares = std::min(num_threads, std::max(points, 1));
+    int share_size = (points + num_shares - 1) / std::max(num_shares, 1);
+    std::vector<std::unique_ptr<HeadlessSynth>> copies;
+    for (int start = share_size; start < points; start += share_size) {
+      copies.push_back(std::make_unique<HeadlessSynth>());
+      copies.back()->copyStateFrom(this);
+    }
+
+    // An exception can't leave a thread, so each share keeps its own and the
+    // first one is rethrown here once every thread is done.
+    std::vector<std::exception_ptr> errors(copies.size() + 1);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < copies.size(); ++i) {
+      SynthBase* synth = copies[i].get();
+      int start = static_cast<int>(i + 1) * share_size;
+      int share_points = std::min(share_size, points - start);
+      threads.emplace_back([=, &values, &control_ids, &data, &errors] {
+        try {
+          ScopedLock copy_lock(synth->getCriticalSection());
+          std::vector<vital::Value*> copy_controls;
+          for (int id : control_ids)
+            copy_controls.push_back(synth->getControl(id));
+          synth->renderSweepPoints(copy_controls, values.data() + start * num_controls, share_points,
+                                   midi_note, velocity, note_dur, total_samples, data.get() + start * item_frames);
         }
-      }
+        catch (...) {
+          errors[i + 1] = std::current_exception();
+        }
+      });
+    }
+
+    try {
+      renderSweepPoints(controls, values.data(), std::min(share_size, points),
+                        midi_note, velocity, note_dur, total_samples, data.get());
+    }
+    catch (...) {
+      errors[0] = std::current_exception();
+    }
+    for (std::thread& thread : threads)
+      thread.join();
+
+    for (size_t c = 0; c < num_controls; ++c)
+      setControlHard(controls[c], original_values[c]);
+    engine_->updateAllModulationSwitches();
+    engine_->checkOversampling();
+
+    for (const std::exception_ptr& error : errors) {
+      if (error)
+        std::rethrow_exception(error);
     }
   }
-  // GIL re-acquired here (RAII) before any Python interaction below.
 
-  // Create capsule with the data. Constructing the capsule is the point of no
-  // return: if it succeeds it owns the buffer, so only release the unique_ptr
-  // afterwards.
   nb::capsule owner(data.get(), [](void* p) noexcept { delete[] (float*)p; });
   float* raw_data = data.release();
+  return nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy>(
+      raw_data, {static_cast<size_t>(points), 2, static_cast<size_t>(total_samples)}, owner);
+}
+
+void SynthBase::renderAudioIntoNumpy(nb::ndarray<float, nb::ndim<2>, nb::c_contig, nb::device::cpu> out,
+                                     const int& midi_note, float velocity, float note_dur) {
+  // (2, S) is planar and (S, 2) interleaved. A (2, 2) array reads as planar.
+  bool planar = out.shape(0) == 2;
+  if (!planar && out.shape(1) != 2)
+    throw std::invalid_argument("out must be shaped (2, num_samples) or (num_samples, 2).");
+
+  float* data = out.data();
+  size_t total_samples = planar ? out.shape(1) : out.shape(0);
+  if (total_samples > static_cast<size_t>(std::numeric_limits<int>::max()))
+    throw std::invalid_argument("out has too many samples to render.");
+
+  // The array belongs to Python, but nanobind holds a reference to it for the
+  // duration of the call, so writing to it with the GIL released is safe. It
+  // is the caller's job not to resize or read it from another thread meanwhile.
+  nb::gil_scoped_release gil_release;
+  ScopedLock lock(getCriticalSection());
 
-  // Return the data as a NumPy array
-  return nb::ndarray<float, nb::shape<2, -1>, nb::numpy>(
-      raw_data, {2, static_cast<size_t>(total_samples)}, owner);
+  processModulationChanges();
+  engine_->updateAllModulationSwitches();
+
+  int samples = static_cast<int>(total_samples);
+  if (planar)
+    renderNoteToBuffers(midi_note, velocity, note_dur, samples, data, data + samples, 1, TailTrim());
+  else
+    renderNoteToBuffers(midi_note, velocity, note_dur, samples, data, data + 1, 2, TailTrim());
 }
 
-bool SynthBase::renderAudioToFile2(const std::string& output_path, const int& midi_note, float velocity, float note_dur, float render_dur) {
-    File output_file(output_path);
-    if (!output_file.hasWriteAccess()) {
-      std::cout << "Error: Don't have permission to write output file." << newLine;
-      return false;
+std::unique_ptr<RenderSession> SynthBase::startRenderSession(const int& midi_note, float velocity, float note_dur,
+                                                            float render_dur, int chunk_blocks) {
+  if (chunk_blocks <= 0)
+    throw std::invalid_argument("chunk_blocks must be positive.");
+
+  std::unique_ptr<RenderSession> session(new RenderSession(this, chunk_blocks * kRenderBufferSize));
+
+  nb::gil_scoped_release gil_release;
+  ScopedLock lock(getCriticalSection());
+
+  processModulationChanges();
+  engine_->updateAllModulationSwitches();
+  startNoteRender(session->render_, midi_note, velocity, note_dur, render_dur * getSampleRate());
+  session->settings_ = captureRenderSettings();
+  return session;
+}
+
+void SynthBase::renderMidiToBuffers(MidiBuffer& midi, int total_samples, float* left, float* right) {
+  double current_time = warmUpForRender();
+  ++render_generation_;
+
+  double sample_time = 1.0 / getSampleRate();
+  const vital::mono_float* engine_output = (const vital::mono_float*)engine_->output(0)->buffer;
+
+  for (int samples = 0; samples < total_samples; samples += kRenderBufferSize) {
+    // Events inside the block reach the voices with their offset into it, so
+    // timing is exact to the sample rather than to the block.
+    processMidi(midi, samples, samples + kRenderBufferSize);
+
+    engine_->correctToTime(current_time);
+    current_time += kRenderBufferSize * sample_time;
+    engine_->process(kRenderBufferSize);
+    updateMemoryOutput(kRenderBufferSize, engine_->output(0)->buffer);
+
+    vital::mono_float t = (total_samples - samples) / (1.0f * kRenderFadeSamples);
+    t = vital::utils::min(t, 1.0f);
+    int block_samples = std::min(kRenderBufferSize, total_samples - samples);
+    for (int i = 0; i < block_samples; ++i) {
+      left[samples + i] = t * engine_output[vital::poly_float::kSize * i];
+      right[samples + i] = t * engine_output[vital::poly_float::kSize * i + 1];
     }
-    bool render_images = false;
-    std::vector<int> midi_notes = {midi_note};
-    
-    renderAudioToFile(output_file, midi_notes, velocity, note_dur, render_dur, render_images);
-    return true;
+  }
+}
+
+nb::ndarray<float, nb::shape<2, -1>, nb::numpy> SynthBase::renderMidiToNumpy(MidiBuffer& midi, float render_dur) {
+  std::unique_ptr<float[]> data;
+  int total_samples = 0;
+
+  {
+    nb::gil_scoped_release gil_release;
+    ScopedLock lock(getCriticalSection());
+
+    processModulationChanges();
+    engine_->updateAllModulationSwitches();
+
+    total_samples = std::max(0, static_cast<int>(render_dur * getSampleRate()));
+    data.reset(new float[std::max<size_t>(1, 2 * static_cast<size_t>(total_samples))]);
+    renderMidiToBuffers(midi, total_samples, data.get(), data.get() + total_samples);
+  }
+
+  return planarArray(std::move(data), total_samples);
+}
+
+nb::ndarray<float, nb::shape<2, -1>, nb::numpy> SynthBase::renderEventsToNumpy(
+    const std::vector<std::tuple<double, int, int, int>>& events, float render_dur) {
+  int sample_rate = getSampleRate();
+  MidiBuffer midi;
+  for (const auto& [time, status, data1, data2] : events) {
+    if (status < 0x80 || status > 0xef)
+      throw std::invalid_argument("Event status " + std::to_string(status) + " is not a channel message.");
+    if (data1 < 0 || data1 > 0x7f || data2 < 0 || data2 > 0x7f)
+      throw std::invalid_argument("Event data bytes must be in the range 0-127.");
+    if (time < 0.0)
+      throw std::invalid_argument("Event times must not be negative.");
+
+    int sample_position = static_cast<int>(std::lround(time * sample_rate));
+    midi.addEvent(MidiMessage(status, data1, data2), sample_position);
+  }
+
+  return renderMidiToNumpy(midi, render_dur);
+}
+
+nb::ndarray<float, nb::shape<2, -1>, nb::numpy> SynthBase::renderMidiFileToNumpy(const std::string& path,
+                                                                                 std::optional<float> render_dur) {
+  static constexpr float kMidiFileTailSeconds = 2.0f;
+
+  File file(path);
+  if (!file.existsAsFile())
+    throw std::invalid_argument("No MIDI file at " + path);
+
+  FileInputStream stream(file);
+  MidiFile midi_file;
+  if (!stream.openedOk() || !midi_file.readFrom(stream))
+    throw std::runtime_error("Could not read MIDI file " + path);
+  midi_file.convertTimestampTicksToSeconds();
+
+  // Merge every track onto one timeline. Meta events (tempo, names, end of
+  // track) have already done their job in the conversion to seconds.
+  int sample_rate = getSampleRate();
+  MidiBuffer midi;
+  double last_time = 0.0;
+  for (int track = 0; track < midi_file.getNumTracks(); ++track) {
+    for (const MidiMessageSequence::MidiEventHolder* event : *midi_file.getTrack(track)) {
+      const MidiMessage& message = event->message;
+      if (message.isMetaEvent() || message.isSysEx())
+        continue;
+
+      last_time = std::max(last_time, message.getTimeStamp());
+      midi.addEvent(message, static_cast<int>(std::lround(message.getTimeStamp() * sample_rate)));
+    }
+  }
+
+  float length = render_dur ? *render_dur : static_cast<float>(last_time) + kMidiFileTailSeconds;
+  return renderMidiToNumpy(midi, length);
+}
+
+bool SynthBase::renderAudioToFile2(const std::string& output_path, const int& midi_note, float velocity,
+                                   float note_dur, float render_dur, int bit_depth) {
+  checkAudioFileFormat(output_path, bit_depth);
+  File output_file(output_path);
+  if (!output_file.hasWriteAccess()) {
+    std::cout << "Error: Don't have permission to write output file." << newLine;
+    return false;
+  }
+
+  std::unique_ptr<float[]> data;
+  int total_samples = 0;
+  double sample_rate = 0.0;
+  {
+    ScopedLock lock(getCriticalSection());
+    processModulationChanges();
+    engine_->updateAllModulationSwitches();
+
+    sample_rate = getSampleRate();
+    total_samples = std::max(0, static_cast<int>(render_dur * sample_rate));
+    data.reset(new float[std::max(1, 2 * total_samples)]);
+    renderNoteToBuffers(midi_note, velocity, note_dur, total_samples, data.get(), data.get() + total_samples, 1,
+                        TailTrim());
+  }
+
+  return writeAudioFile(output_file, data.get(), data.get() + total_samples, total_samples, sample_rate, bit_depth);
+}
+
+std::vector<bool> SynthBase::renderAudioToFiles(const std::vector<FileRenderJob>& jobs, int bit_depth) {
+  for (const FileRenderJob& job : jobs)
+    checkAudioFileFormat(job.output_path, bit_depth);
+
+  struct RenderedFile {
+    size_t index;
+    std::unique_ptr<float[]> audio;
+    int num_samples;
+  };
+
+  // Only the I/O thread writes results, until it is joined.
+  std::vector<bool> results(jobs.size(), false);
+  std::deque<RenderedFile> pending;
+  std::mutex mutex;
+  std::condition_variable pending_changed;
+  bool rendering_done = false;
+  // Set before the first file is queued, which is when the I/O thread
+  // first reads it.
+  double sample_rate = 0.0;
+
+  std::thread io_thread([&] {
+    while (true) {
+      RenderedFile file;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        pending_changed.wait(lock, [&] { return rendering_done || !pending.empty(); });
+        if (pending.empty())
+          return;
+
+        file = std::move(pending.front());
+        pending.pop_front();
+      }
+      pending_changed.notify_all();
+
+      const float* left = file.audio.get();
+      results[file.index] = writeAudioFile(File(jobs[file.index].output_path), left, left + file.num_samples,
+                                           file.num_samples, sample_rate, bit_depth);
+    }
+  });
+
+  auto finishWriting = [&] {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      rendering_done = true;
+    }
+    pending_changed.notify_all();
+    io_thread.join();
+  };
+
+  try {
+    ScopedLock lock(getCriticalSection());
+    processModulationChanges();
+    engine_->updateAllModulationSwitches();
+    sample_rate = getSampleRate();
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      const FileRenderJob& job = jobs[i];
+      int total_samples = std::max(0, static_cast<int>(job.render_dur * sample_rate));
+      std::unique_ptr<float[]> audio(new float[std::max(1, 2 * total_samples)]);
+      renderNoteToBuffers(job.midi_note, job.velocity, job.note_dur, total_samples, audio.get(),
+                          audio.get() + total_samples, 1, TailTrim());
+
+      // Bounded so a slow disk holds back rendering rather than memory.
+      std::unique_lock<std::mutex> queue_lock(mutex);
+      pending_changed.wait(queue_lock, [&] { return pending.size() < kMaxPendingFiles; });
+      pending.push_back({ i, std::move(audio), total_samples });
+      queue_lock.unlock();
+      pending_changed.notify_all();
+    }
+  }
+  catch (...) {
+    finishWriting();
+    throw;
+  }
+
+  finishWriting();
+  return results;
 }
 
 
@@ -689,14 +1908,7 @@ void SynthBase::renderAudioForResynthesis(float* data, int samples, int note) {
   ScopedLock lock(getCriticalSection());
 
   double sample_time = 1.0 / getSampleRate();
-  double current_time = -kPreProcessSamples * sample_time;
-
-  engine_->allSoundsOff();
-  for (int s = 0; s < kPreProcessSamples; s += kBufferSize) {
-    engine_->correctToTime(current_time);
-    current_time += kBufferSize * sample_time;
-    engine_->process(kBufferSize);
-  }
+  double current_time = warmUpForRender(kPreProcessSamples);
 
   engine_->noteOn(note, 0.7f, 0, 0);
   const vital::poly_float* engine_output = engine_->output(0)->buffer;
@@ -934,6 +2146,17 @@ void SynthBase::checkOversampling() {
   return engine_->checkOversampling();
 }
 
+std::unique_ptr<HeadlessSynth> HeadlessSynth::clone() {
+  nb::gil_scoped_release release;
+  // Build the engine before taking the lock so other renders on this synth
+  // only wait for the copy itself.
+  std::unique_ptr<HeadlessSynth> copy = std::make_unique<HeadlessSynth>();
+
+  ScopedLock lock(getCriticalSection());
+  copy->copyStateFrom(this);
+  return copy;
+}
+
 void SynthBase::ValueChangedCallback::messageCallback() {
   if (auto synth_base = listener.lock()) {
     SynthGuiInterface* gui_interface = (*synth_base)->getGuiInterface();
@@ -944,3 +2167,34 @@ void SynthBase::ValueChangedCallback::messageCallback() {
     }
   }
 }
+
+RenderSession::RenderSession(SynthBase* synth, int chunk_samples) :
+    synth_(synth), chunk_samples_(chunk_samples) { }
+
+RenderSnapshot::RenderSnapshot(SynthBase* synth, int warmup_samples) :
+    synth_(synth), warmup_samples_(warmup_samples), load_generation_(0), start_time_(0.0) { }
+
+nb::ndarray<float, nb::shape<2, -1>, nb::numpy> RenderSession::next() {
+  if (done())
+    throw nb::stop_iteration();
+
+  std::unique_ptr<float[]> data;
+  int num_samples = 0;
+
+  {
+    // The GIL is only released while this chunk renders. Between chunks the
+    // engine is left exactly as the last block left it, so the next chunk
+    // carries on seamlessly.
+    nb::gil_scoped_release gil_release;
+    ScopedLock lock(synth_->getCriticalSection());
+
+    if (synth_->render_generation_ != render_.generation || !synth_->renderSettingsMatch(settings_))
+      throw std::runtime_error("The Synth rendered something else or was changed since this stream started.");
+
+    num_samples = std::min(chunk_samples_, render_.total_samples - render_.position);
+    data.reset(new float[2 * static_cast<size_t>(num_samples)]);
+    synth_->continueNoteRender(render_, num_samples, data.get(), data.get() + num_samples, 1);
+  }
+
+  return planarArray(std::move(data), num_samples);
+}
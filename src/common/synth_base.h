@@ -22,11 +22,15 @@
 #include "synth_constants.h"
 #include "synth_types.h"
 #include "midi_manager.h"
+#include "processor_snapshot.h"
 #include "tuning.h"
 #include "wavetable_creator.h"
 
+#include <optional>
 #include <set>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
@@ -46,12 +50,17 @@ namespace vital {
   class Wavetable;
 }
 
+class RenderSession;
+class RenderSnapshot;
 class SynthGuiInterface;
 
 class SynthBase : public MidiManager::Listener {
   public:
     static constexpr float kOutputWindowMinNote = 16.0f;
     static constexpr float kOutputWindowMaxNote = 128.0f;
+    static constexpr float kDefaultTailThresholdDb = -90.0f;
+    static constexpr float kDefaultTailHold = 0.1f;
+    static constexpr int kRenderPreProcessSamples = 256; // note: dbraun decreased this from 44100.
 
     SynthBase();
     virtual ~SynthBase();
@@ -95,10 +104,108 @@ class SynthBase : public MidiManager::Listener {
     bool pyLoadFromFile(std::string path);
     std::string pyToJson() { return saveToJson().dump(); }
     bool loadFromString(std::string json_text);
+    MemoryBlock saveToBinary();
+    bool loadFromBinary(const void* data, size_t size);
+
+    // Makes this synth a copy of source: controls, modulations, LFO shapes,
+    // sample, wavetables, preset info and sample rate. Rendered wavetable and
+    // sample data are copied as they are rather than rebuilt. The caller holds
+    // source's critical section.
+    void copyStateFrom(SynthBase* source);
     void renderAudioToFile(File file, std::vector<int> notes, float velocity, float note_dur, float render_dur, bool render_images);
-    bool renderAudioToFile2(const std::string& output_path, const int& midi_note, float velocity, float note_dur, float render_dur);
-    nb::ndarray<float, nb::shape<2, -1>, nb::numpy> renderAudioToNumpy(const int& midi_note, float velocity, float note_dur, float render_dur);
+    // Renders one note and writes it in one go to a WAV file of bit_depth 16
+    // or 24 bit PCM or 32 bit float, or to FLAC of 16 or 24 bits when the path
+    // ends in .flac. Returns false if the file cannot be written.
+    bool renderAudioToFile2(const std::string& output_path, const int& midi_note, float velocity, float note_dur,
+                            float render_dur, int bit_depth = 16);
+
+    struct FileRenderJob {
+      std::string output_path;
+      int midi_note = 0;
+      float velocity = 0.0f;
+      float note_dur = 0.0f;
+      float render_dur = 0.0f;
+    };
+    // renderAudioToFile2 for each job, with the encoding and writing done on
+    // a separate thread while the next job renders. Returns whether each file
+    // was written.
+    std::vector<bool> renderAudioToFiles(const std::vector<FileRenderJob>& jobs, int bit_depth = 16);
+    // Sample types a render can be returned as. int16 and float16 are
+    // quantized as the audio is copied out of the engine, so no float32 copy
+    // of the render is ever made.
+    enum SampleFormat {
+      kFloat32,
+      kInt16,
+      kFloat16
+    };
+    // "float32", "int16" or "float16"; throws std::invalid_argument otherwise.
+    static SampleFormat sampleFormatFromName(const std::string& name);
+
+    // Renders one note of total_samples frames into caller-owned planar
+    // left/right buffers of format samples. Takes the critical section
+    // itself and touches no Python objects, so callers need not hold the GIL.
+    void renderNoteToMemory(int midi_note, float velocity, float note_dur, int total_samples,
+                            void* left, void* right, SampleFormat format);
+
+    // dither adds TPDF dither of one least significant bit and is only
+    // allowed with kInt16. The noise depends only on dither_seed, so equal
+    // calls give equal output whatever was rendered before.
+    nb::ndarray<nb::numpy, nb::shape<2, -1>> renderAudioToNumpy(const int& midi_note, float velocity, float note_dur,
+                                                                float render_dur, bool trim_tail = false,
+                                                                float tail_threshold_db = kDefaultTailThresholdDb,
+                                                                float tail_hold = kDefaultTailHold,
+                                                                SampleFormat format = kFloat32, bool dither = false,
+                                                                uint32_t dither_seed = 0);
+    nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy> renderBatchToNumpy(const std::vector<int>& midi_notes,
+                                                                         const std::vector<float>& velocities,
+                                                                         const std::vector<float>& note_durs,
+                                                                         float render_dur,
+                                                                         bool trim_tail = false,
+                                                                         float tail_threshold_db = kDefaultTailThresholdDb,
+                                                                         float tail_hold = kDefaultTailHold);
+    // Renders one note once, optionally split into stems and with modulation
+    // captured alongside. With stems, the audio is (num_stems, 2,
+    // total_samples): "osc_1" to "osc_3" and "sample" before filters and
+    // effects, "dry" and "wet" around the effect chain, and "mix", the normal
+    // output. Without, it is the usual (2, total_samples). Each name in
+    // capture, a status output such as "lfo_1" or a modulation destination,
+    // is recorded once per render block into a (num_blocks, 2) array. Returns
+    // the audio, or (audio, {name: array}) when capture is not empty.
+    nb::object renderTappedToNumpy(int midi_note, float velocity, float note_dur, float render_dur,
+                                   const std::optional<std::vector<std::string>>& stems,
+                                   const std::vector<std::string>& capture);
+    nb::ndarray<float, nb::shape<-1, 2, -1>, nb::numpy> renderSweepToNumpy(
+        const std::vector<std::string>& control_names,
+        nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> value_grid,
+        int midi_note, float velocity, float note_dur, float render_dur, int num_threads);
+    // The rendering behind renderBatchToNumpy, for callers on threads that do
+    // not hold the GIL. Returns (num_notes, 2, total_samples) planar audio.
+    // velocities and note_durs have one entry or one per note.
+    std::unique_ptr<float[]> renderBatchToBuffer(const std::vector<int>& midi_notes,
+                                                 const std::vector<float>& velocities,
+                                                 const std::vector<float>& note_durs, float render_dur,
+                                                 bool trim_tail, float tail_threshold_db, float tail_hold,
+                                                 int& total_samples);
+    void renderAudioIntoNumpy(nb::ndarray<float, nb::ndim<2>, nb::c_contig, nb::device::cpu> out,
+                              const int& midi_note, float velocity, float note_dur);
+    std::unique_ptr<RenderSession> startRenderSession(const int& midi_note, float velocity, float note_dur,
+                                                      float render_dur, int chunk_blocks);
+    nb::ndarray<float, nb::shape<2, -1>, nb::numpy> renderEventsToNumpy(
+        const std::vector<std::tuple<double, int, int, int>>& events, float render_dur);
+    nb::ndarray<float, nb::shape<2, -1>, nb::numpy> renderMidiFileToNumpy(const std::string& path,
+                                                                         std::optional<float> render_dur);
     void renderAudioForResynthesis(float* data, int samples, int note);
+
+    // Resets the voices, runs the engine for warmup_samples and saves the
+    // state of every processor. While it is the active snapshot, renders
+    // restore it in place of their own warm-up, as long as the controls,
+    // modulations and preset are still the ones it was taken with.
+    std::shared_ptr<RenderSnapshot> takeRenderSnapshot(int warmup_samples);
+    // Puts the engine back as snapshot saved it, control values included, and
+    // makes it the active snapshot.
+    void restoreRenderSnapshot(const std::shared_ptr<RenderSnapshot>& snapshot);
+    void clearRenderSnapshot();
+
     bool saveToFile(File preset);
     bool saveToActiveFile();
     void clearActiveFile() { active_file_ = File(); }
@@ -126,6 +233,29 @@ class SynthBase : public MidiManager::Listener {
     String getMacroName(int index);
 
     vital::control_map& getControls() { return controls_; }
+
+    // Controls indexed by parameter ID, the parameter's index in
+    // vital::Parameters. Parameters the engine has no control for are null.
+    const std::vector<vital::Value*>& getControlTable() { return control_table_; }
+    vital::Value* getControl(int id) { return control_table_[id]; }
+
+    // Every parameter's value in ID order, as plain values or 0-1 knob
+    // positions. Parameters without a control read as their default and are
+    // skipped when setting. Each call takes the lock once for the whole vector.
+    nb::ndarray<float, nb::shape<-1>, nb::numpy> getParameterVector(bool normalized);
+    void setParameterVector(nb::ndarray<const float, nb::ndim<1>, nb::c_contig, nb::device::cpu> values,
+                            bool normalized);
+
+    // Draws new values for the controls matching include (every control when
+    // empty) and not matching exclude. Patterns may use * and ? wildcards.
+    // Indexed controls pick an option uniformly; continuous ones draw
+    // uniformly over the knob position ("uniform_normalized") or the plain
+    // range ("uniform"). num_modulations > 0 replaces the modulation routing
+    // with that many random source-destination pairs. The same seed on the
+    // same preset always gives the same result.
+    void randomize(uint64_t seed, const std::vector<std::string>& include,
+                   const std::vector<std::string>& exclude, const std::string& distribution,
+                   int num_modulations);
     vital::SoundEngine* getEngine() { return engine_.get(); }
     MidiKeyboardState* getKeyboardState() { return keyboard_state_.get(); }
     const vital::poly_float* getOscilloscopeMemory() { return oscilloscope_memory_; }
@@ -160,6 +290,12 @@ class SynthBase : public MidiManager::Listener {
     void pySetBPM(float bpm);
     void setSampleRate(double sample_rate);
 
+    // Render quality: "draft", "normal" and "high" fix the engine's
+    // oversampling at 1x, 2x and 4x whatever the preset says. No quality
+    // follows the preset's oversampling setting, which is the default.
+    void setQuality(const std::optional<std::string>& quality);
+    std::optional<std::string> getQuality();
+
     struct ValueChangedCallback : public CallbackMessage {
       ValueChangedCallback(std::shared_ptr<SynthBase*> listener, std::string name, vital::mono_float val) :
           listener(listener), control_name(std::move(name)), value(val) { }
@@ -198,6 +334,107 @@ class SynthBase : public MidiManager::Listener {
     void processModulationChanges();
     void updateMemoryOutput(int samples, const vital::poly_float* audio);
 
+    // Resets the voices and runs the engine for pre_process_samples so
+    // modulators settle, or restores the active render snapshot if it
+    // still matches.
+    // Returns the engine time at which the render proper starts.
+    double warmUpForRender(int pre_process_samples = kRenderPreProcessSamples);
+
+    // The inputs that shape what a render sounds like, kept to tell whether
+    // any of them changed since a render was set up.
+    struct RenderSettings {
+      int sample_rate = 0;
+      std::vector<vital::mono_float> control_values;
+      std::vector<vital::ModulationConnection*> connections;
+    };
+
+    RenderSettings captureRenderSettings();
+    bool renderSettingsMatch(const RenderSettings& settings);
+
+    // Ends any stream in progress and retires render snapshots, for changes
+    // RenderSettings can't see such as a preset load.
+    void invalidateRenders();
+
+    // Renders total_samples frames into planar left/right buffers, feeding
+    // the events in midi to the engine at their sample positions.
+    void renderMidiToBuffers(MidiBuffer& midi, int total_samples, float* left, float* right);
+    nb::ndarray<float, nb::shape<2, -1>, nb::numpy> renderMidiToNumpy(MidiBuffer& midi, float render_dur);
+
+    // Stops a note render early once its release has decayed: after the note
+    // off, when the peak output stays below threshold (linear) for
+    // hold_samples. A zero threshold renders the full length.
+    struct TailTrim {
+      float threshold = 0.0f;
+      int hold_samples = 0;
+    };
+
+    TailTrim makeTailTrim(bool trim_tail, float threshold_db, float hold_seconds);
+
+    // Where a captured value is read from. A status output is read as is. A
+    // modulation destination is its base value, or the mono modulation total
+    // once the mono switch is on, plus the last voice's polyphonic modulation
+    // when a polyphonic source is connected.
+    struct CaptureSource {
+      const vital::StatusOutput* status = nullptr;
+      const vital::Value* base = nullptr;
+      const vital::ValueSwitch* mono_switch = nullptr;
+      const vital::Output* mono = nullptr;
+      const vital::Output* poly = nullptr;
+    };
+    CaptureSource makeCaptureSource(const std::string& name);
+    static vital::poly_float readCaptureSource(const CaptureSource& source);
+
+    // Where a single-note render has got to, so that it can be run in pieces.
+    // generation identifies the render; starting another one invalidates it.
+    // A render cut short by trim has total_samples reduced to where it ended.
+    struct NoteRender {
+      int midi_note = 0;
+      int on_samples = 0;
+      int total_samples = 0;
+      int position = 0;
+      double current_time = 0.0;
+      int generation = 0;
+      TailTrim trim;
+      int silent_samples = 0;
+      // If set, each SoundEngine stem in stem_ids is also written, planar, to
+      // consecutive (2, total_samples) slices of stem_data. Negative IDs are
+      // skipped, leaving their slice to the caller.
+      const std::vector<int>* stem_ids = nullptr;
+      float* stem_data = nullptr;
+      // If set, each source is read after every block into consecutive
+      // (num_blocks, 2) slices of capture_data.
+      const std::vector<CaptureSource>* captures = nullptr;
+      float* capture_data = nullptr;
+      int capture_blocks = 0;
+      // The sample type of the left/right buffers. A nonzero dither_state
+      // seeds TPDF dither for kInt16.
+      SampleFormat format = kFloat32;
+      uint32_t dither_state = 0;
+    };
+
+    // Resets the voices, warms the engine up and plays the note. The caller
+    // holds the critical section and has already flushed pending modulation
+    // changes, here and in the two functions below.
+    void startNoteRender(NoteRender& render, int midi_note, float velocity, float note_dur, int total_samples);
+
+    // Renders the next num_samples frames (fewer at the end) into the
+    // left/right buffers, which hold render.format samples, stepping stride
+    // samples per frame. num_samples must be a multiple of the render block
+    // size except on the final call.
+    void continueNoteRender(NoteRender& render, int num_samples, void* left, void* right, int stride);
+
+    // Renders one note per grid point, points rows of values for controls,
+    // into consecutive (2, total_samples) slices of output. The caller holds
+    // the critical section. Leaves the controls at the last point's values.
+    void renderSweepPoints(const std::vector<vital::Value*>& controls, const float* values, int points,
+                           int midi_note, float velocity, float note_dur, int total_samples, float* output);
+
+    // startNoteRender and continueNoteRender for the whole length at once.
+    // Returns the number of frames rendered, fewer than total_samples if trim
+    // cut the render short.
+    int renderNoteToBuffers(int midi_note, float velocity, float note_dur, int total_samples,
+                            float* left, float* right, int stride, const TailTrim& trim);
+
     std::unique_ptr<vital::SoundEngine> engine_;
     std::unique_ptr<MidiManager> midi_manager_;
     std::unique_ptr<MidiKeyboardState> keyboard_state_;
@@ -218,14 +455,70 @@ class SynthBase : public MidiManager::Listener {
 
     std::map<std::string, String> save_info_;
     vital::control_map controls_;
+    std::vector<vital::Value*> control_table_;
     vital::CircularQueue<vital::ModulationConnection*> mod_connections_;
     moodycamel::ConcurrentQueue<vital::control_change> value_change_queue_;
     moodycamel::ConcurrentQueue<vital::modulation_change> modulation_change_queue_;
     Tuning tuning_;
+    int render_generation_ = 0;
+    int load_generation_ = 0;
+    std::shared_ptr<RenderSnapshot> render_snapshot_;
+
+    friend class RenderSession;
+    friend class RenderSnapshot;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthBase)
 };
 
+// One note rendered a chunk at a time, for long renders that should not be
+// held in memory all at once. Created by SynthBase::startRenderSession; the
+// synth must outlive it and should not render anything else meanwhile.
+class RenderSession {
+  public:
+    bool done() const { return render_.position >= render_.total_samples; }
+    int chunkSamples() const { return chunk_samples_; }
+    int totalSamples() const { return render_.total_samples; }
+    int position() const { return render_.position; }
+
+    // Renders and returns the next chunk, throwing nb::stop_iteration once
+    // the render is complete.
+    nb::ndarray<float, nb::shape<2, -1>, nb::numpy> next();
+
+  private:
+    RenderSession(SynthBase* synth, int chunk_samples);
+
+    SynthBase* synth_;
+    int chunk_samples_;
+    SynthBase::NoteRender render_;
+    SynthBase::RenderSettings settings_;
+
+    friend class SynthBase;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderSession)
+};
+
+// The engine as a render's warm-up left it. Created by
+// SynthBase::takeRenderSnapshot and only restorable on the synth that took it.
+class RenderSnapshot {
+  public:
+    int warmupSamples() const { return warmup_samples_; }
+    size_t sizeInBytes() const { return state_.size(); }
+
+  private:
+    RenderSnapshot(SynthBase* synth, int warmup_samples);
+
+    SynthBase* synth_;
+    int warmup_samples_;
+    int load_generation_;
+    double start_time_;
+    SynthBase::RenderSettings settings_;
+    vital::ProcessorSnapshot state_;
+
+    friend class SynthBase;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderSnapshot)
+};
+
 class HeadlessSynth : public SynthBase {
   public:
     virtual const CriticalSection& getCriticalSection() override {
@@ -239,6 +532,8 @@ class HeadlessSynth : public SynthBase {
         critical_section_.exit();
     }
 
+    std::unique_ptr<HeadlessSynth> clone();
+
   protected:
     virtual SynthGuiInterface* getGuiInterface() override { return nullptr; }
 
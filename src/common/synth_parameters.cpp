@@ -599,6 +599,8 @@ namespace vital {
     details_lookup_["filter_2_osc2_input"].default_value = 1.0f;
 
     std::sort(details_list_.begin(), details_list_.end(), compareValueDetails);
+    for (int i = 0; i < static_cast<int>(details_list_.size()); ++i)
+      index_lookup_[details_list_[i]->name] = i;
   }
 
   void ValueDetailsLookup::addParameterGroup(const ValueDetails* list, int num_parameters, int index,
@@ -668,6 +670,200 @@ namespace vital {
     }
   } // namespace
 
+  namespace {
+    mono_float clampNormalized(mono_float normalized) {
+      return std::max(0.0f, std::min(1.0f, normalized));
+    }
+
+    // Knob position to the position within the parameter's range, before
+    // scaling to min and max. Indexed parameters are handled separately.
+    mono_float unskewNormalized(const ValueDetails& details, mono_float normalized) {
+      switch (details.value_scale) {
+        case ValueDetails::kQuadratic:
+          return std::sqrt(normalized);
+        case ValueDetails::kCubic:
+          return std::pow(normalized, 1.0f / 3.0f);
+        case ValueDetails::kExponential:
+          if (details.display_invert)
+            return 1.0f / std::pow(2.0f, normalized);
+          return std::pow(2.0f, normalized);
+        case ValueDetails::kSquareRoot:
+          return normalized * normalized;
+        default:
+          return normalized;
+      }
+    }
+
+    mono_float skewNormalized(const ValueDetails& details, mono_float position) {
+      switch (details.value_scale) {
+        case ValueDetails::kQuadratic:
+          return position * position;
+        case ValueDetails::kCubic:
+          return position * position * position;
+        case ValueDetails::kExponential:
+          if (details.display_invert)
+            return -std::log2(position + 1e-10f);
+          return std::log2(position + 1e-10f);
+        case ValueDetails::kSquareRoot:
+          return std::sqrt(position);
+        default:
+          return position;
+      }
+    }
+
+    // Parameter indices grouped by how they convert, each group laid out as
+    // contiguous arrays so its conversion is one branch-free loop the
+    // compiler can vectorize. Exponential and cubic parameters call into the
+    // math library per value and share one group.
+    struct ConversionGroup {
+      enum Kind {
+        kIndexed,
+        kLinear,
+        kQuadratic,
+        kSquareRoot,
+        kOther,
+        kNumKinds
+      };
+
+      std::vector<int> indices;
+      std::vector<mono_float> mins;
+      std::vector<mono_float> ranges;
+    };
+
+    ConversionGroup::Kind conversionKind(const ValueDetails& details) {
+      switch (details.value_scale) {
+        case ValueDetails::kIndexed:
+          return ConversionGroup::kIndexed;
+        case ValueDetails::kLinear:
+        case ValueDetails::kQuartic:
+          return ConversionGroup::kLinear;
+        case ValueDetails::kQuadratic:
+          return ConversionGroup::kQuadratic;
+        case ValueDetails::kSquareRoot:
+          return ConversionGroup::kSquareRoot;
+        default:
+          return ConversionGroup::kOther;
+      }
+    }
+
+    const std::vector<ConversionGroup>& conversionGroups() {
+      static const std::vector<ConversionGroup> groups = [] {
+        std::vector<ConversionGroup> result(ConversionGroup::kNumKinds);
+        for (int i = 0; i < Parameters::getNumParameters(); ++i) {
+          const ValueDetails* details = Parameters::getDetails(i);
+          ConversionGroup& group = result[conversionKind(*details)];
+          group.indices.push_back(i);
+          group.mins.push_back(details->min);
+          group.ranges.push_back(details->max - details->min);
+        }
+        return result;
+      }();
+      return groups;
+    }
+  } // namespace
+
+  mono_float Parameters::getValueFromNormalized(const ValueDetails& details, mono_float normalized) {
+    normalized = clampNormalized(normalized);
+    mono_float range = details.max - details.min;
+    if (details.value_scale == ValueDetails::kIndexed)
+      return details.min + std::round(normalized * range);
+    return details.min + unskewNormalized(details, normalized) * range;
+  }
+
+  mono_float Parameters::getNormalizedFromValue(const ValueDetails& details, mono_float value) {
+    mono_float range = details.max - details.min;
+    if (details.value_scale == ValueDetails::kIndexed)
+      return std::round(value - details.min) / range;
+    return clampNormalized(skewNormalized(details, (value - details.min) / range));
+  }
+
+  void Parameters::getValuesFromNormalized(const mono_float* normalized, mono_float* values) {
+    const std::vector<ConversionGroup>& groups = conversionGroups();
+    std::vector<mono_float> scratch;
+    for (int kind = 0; kind < ConversionGroup::kNumKinds; ++kind) {
+      const ConversionGroup& group = groups[kind];
+      int size = static_cast<int>(group.indices.size());
+      scratch.resize(size);
+      mono_float* x = scratch.data();
+      const mono_float* mins = group.mins.data();
+      const mono_float* ranges = group.ranges.data();
+
+      for (int i = 0; i < size; ++i)
+        x[i] = clampNormalized(normalized[group.indices[i]]);
+
+      switch (kind) {
+        case ConversionGroup::kIndexed:
+          for (int i = 0; i < size; ++i)
+            x[i] = mins[i] + std::round(x[i] * ranges[i]);
+          break;
+        case ConversionGroup::kLinear:
+          for (int i = 0; i < size; ++i)
+            x[i] = mins[i] + x[i] * ranges[i];
+          break;
+        case ConversionGroup::kQuadratic:
+          for (int i = 0; i < size; ++i)
+            x[i] = mins[i] + std::sqrt(x[i]) * ranges[i];
+          break;
+        case ConversionGroup::kSquareRoot:
+          for (int i = 0; i < size; ++i)
+            x[i] = mins[i] + (x[i] * x[i]) * ranges[i];
+          break;
+        default:
+          for (int i = 0; i < size; ++i)
+            x[i] = mins[i] + unskewNormalized(*getDetails(group.indices[i]), x[i]) * ranges[i];
+          break;
+      }
+
+      for (int i = 0; i < size; ++i)
+        values[group.indices[i]] = x[i];
+    }
+  }
+
+  void Parameters::getNormalizedFromValues(const mono_float* values, mono_float* normalized) {
+    const std::vector<ConversionGroup>& groups = conversionGroups();
+    std::vector<mono_float> scratch;
+    for (int kind = 0; kind < ConversionGroup::kNumKinds; ++kind) {
+      const ConversionGroup& group = groups[kind];
+      int size = static_cast<int>(group.indices.size());
+      scratch.resize(size);
+      mono_float* x = scratch.data();
+      const mono_float* mins = group.mins.data();
+      const mono_float* ranges = group.ranges.data();
+
+      if (kind == ConversionGroup::kIndexed) {
+        for (int i = 0; i < size; ++i)
+          x[i] = std::round(values[group.indices[i]] - mins[i]) / ranges[i];
+      }
+      else {
+        for (int i = 0; i < size; ++i)
+          x[i] = (values[group.indices[i]] - mins[i]) / ranges[i];
+
+        switch (kind) {
+          case ConversionGroup::kQuadratic:
+            for (int i = 0; i < size; ++i)
+              x[i] = x[i] * x[i];
+            break;
+          case ConversionGroup::kSquareRoot:
+            for (int i = 0; i < size; ++i)
+              x[i] = std::sqrt(x[i]);
+            break;
+          case ConversionGroup::kOther:
+            for (int i = 0; i < size; ++i)
+              x[i] = skewNormalized(*getDetails(group.indices[i]), x[i]);
+            break;
+          default:
+            break;
+        }
+
+        for (int i = 0; i < size; ++i)
+          x[i] = clampNormalized(x[i]);
+      }
+
+      for (int i = 0; i < size; ++i)
+        normalized[group.indices[i]] = x[i];
+    }
+  }
+
   size_t Parameters::getStringLookupSize(const ValueDetails& details) {
     if (details.string_lookup == nullptr)
       return 0;
@@ -20,6 +20,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 
 namespace vital {
 
@@ -69,6 +70,13 @@ namespace vital {
         return details_list_[index];
       }
 
+      int getIndex(const std::string& name) const {
+        auto index = index_lookup_.find(name);
+        if (index == index_lookup_.end())
+          return -1;
+        return index->second;
+      }
+
       std::string getDisplayName(const std::string& name) const {
         return getDetails(name).display_name;
       }
@@ -104,6 +112,7 @@ namespace vital {
     private:
       std::map<std::string, ValueDetails> details_lookup_;
       std::vector<const ValueDetails*> details_list_;
+      std::unordered_map<std::string, int> index_lookup_;
 
       JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ValueDetailsLookup)
   };
@@ -122,6 +131,13 @@ namespace vital {
         return lookup_.getDetails(index);
       }
 
+      /** Position of a parameter in the sorted parameter list, or -1 if there
+       *  is no parameter with that name. Indices are fixed once the list is
+       *  built, so they can stand in for names in tight loops. */
+      static int getIndex(const std::string& name) {
+        return lookup_.getIndex(name);
+      }
+
       static std::string getDisplayName(const std::string& name) {
         return lookup_.getDisplayName(name);
       }
@@ -138,6 +154,20 @@ namespace vital {
         return lookup_.getAllDetails();
       }
 
+      /** Plain value for a 0-1 knob position, following the parameter's value
+       *  scale. Positions outside 0-1 are clamped and indexed parameters snap
+       *  to the nearest option. */
+      static mono_float getValueFromNormalized(const ValueDetails& details, mono_float normalized);
+
+      /** Knob position in 0-1 for a plain value, following the parameter's
+       *  value scale. */
+      static mono_float getNormalizedFromValue(const ValueDetails& details, mono_float value);
+
+      /** Converts every parameter at once. Both arrays hold getNumParameters()
+       *  values in index order. The results match the single-value versions. */
+      static void getValuesFromNormalized(const mono_float* normalized, mono_float* values);
+      static void getNormalizedFromValues(const mono_float* values, mono_float* normalized);
+
       /** Number of names reachable through a ValueDetails' string_lookup.
        *
        * ValueDetails::string_lookup is a bare pointer with no length attached,
@@ -15,6 +15,7 @@
  */
 
 #include "file_source.h"
+#include "load_save.h"
 
 FileSource::FileSourceKeyframe::FileSourceKeyframe(SampleBuffer* sample_buffer) {
   sample_buffer_ = sample_buffer;
@@ -260,21 +261,9 @@ WavetableComponentFactory::ComponentType FileSource::getType() {
 }
 
 json FileSource::stateToJson() {
-  double max_position = 0;
-  for (int i = 0; i < numFrames(); ++i)
-    max_position = std::max(max_position, getKeyframe(i)->getStartPosition());
+  json data = parametersToJson();
 
-  json data = WavetableComponent::stateToJson();
-  data["normalize_gain"] = normalize_gain_;
-  data["normalize_mult"] = normalize_mult_;
-  data["window_size"] = window_size_;
-  data["fade_style"] = fade_style_;
-  data["phase_style"] = phase_style_;
-  data["random_seed"] = random_seed_;
-  data["audio_sample_rate"] = sample_buffer_.sample_rate;
-
-  int save_samples = max_position + 2 * window_size_ + kExtraSaveSamples;
-  int num_samples = std::min(sample_buffer_.size, save_samples);
+  int num_samples = numSaveSamples();
   String encoded = "";
   if (getDataBuffer()) {
     std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(num_samples);
@@ -286,6 +275,60 @@ json FileSource::stateToJson() {
 }
 
 void FileSource::jsonToState(json data) {
+  jsonToParameters(data);
+
+  int sample_rate = vital::kDefaultSampleRate;
+  if (data.count("audio_sample_rate"))
+    sample_rate = data["audio_sample_rate"];
+
+  MemoryOutputStream decoded;
+  std::string audio_data = data["audio_file"];
+  Base64::convertFromBase64(decoded, audio_data);
+
+  int size = static_cast<int>(decoded.getDataSize()) / sizeof(int16_t);
+  std::unique_ptr<float[]> float_data = std::make_unique<float[]>(size);
+  vital::utils::pcmToFloatData(float_data.get(), (int16_t*)decoded.getData(), size);
+  loadBuffer(float_data.get(), size, sample_rate);
+}
+
+void FileSource::stateToBinary(MemoryOutputStream& stream) {
+  writeJsonBinary(stream, parametersToJson());
+
+  int num_samples = getDataBuffer() ? numSaveSamples() : 0;
+  stream.writeInt(num_samples);
+  LoadSave::writeAudioBinary(stream, getDataBuffer(), num_samples);
+}
+
+bool FileSource::binaryToState(MemoryInputStream& stream) {
+  json data;
+  if (!readJsonBinary(stream, data))
+    return false;
+  jsonToParameters(data);
+
+  int num_samples = stream.readInt();
+  if (num_samples < 0 || num_samples * sizeof(int16_t) > static_cast<size_t>(stream.getNumBytesRemaining()))
+    return false;
+
+  std::unique_ptr<float[]> float_data = std::make_unique<float[]>(num_samples);
+  if (!LoadSave::readAudioBinary(stream, float_data.get(), num_samples))
+    return false;
+  loadBuffer(float_data.get(), num_samples, data["audio_sample_rate"]);
+  return true;
+}
+
+json FileSource::parametersToJson() {
+  json data = WavetableComponent::stateToJson();
+  data["normalize_gain"] = normalize_gain_;
+  data["normalize_mult"] = normalize_mult_;
+  data["window_size"] = window_size_;
+  data["fade_style"] = fade_style_;
+  data["phase_style"] = phase_style_;
+  data["random_seed"] = random_seed_;
+  data["audio_sample_rate"] = sample_buffer_.sample_rate;
+  return data;
+}
+
+void FileSource::jsonToParameters(json data) {
   normalize_gain_ = data["normalize_gain"];
   if (data.count("normalize_mult"))
     normalize_mult_ = data["normalize_mult"];
@@ -306,19 +349,15 @@ void FileSource::jsonToState(json data) {
   writePhaseOverrideBuffer();
 
   WavetableComponent::jsonToState(data);
+}
 
-  int sample_rate = vital::kDefaultSampleRate;
-  if (data.count("audio_sample_rate"))
-    sample_rate = data["audio_sample_rate"];
-
-  MemoryOutputStream decoded;
-  std::string audio_data = data["audio_file"];
-  Base64::convertFromBase64(decoded, audio_data);
+int FileSource::numSaveSamples() {
+  double max_position = 0;
+  for (int i = 0; i < numFrames(); ++i)
+    max_position = std::max(max_position, getKeyframe(i)->getStartPosition());
 
-  int size = static_cast<int>(decoded.getDataSize()) / sizeof(int16_t);
-  std::unique_ptr<float[]> float_data = std::make_unique<float[]>(size);
-  vital::utils::pcmToFloatData(float_data.get(), (int16_t*)decoded.getData(), size);
-  loadBuffer(float_data.get(), size, sample_rate);
+  int save_samples = max_position + 2 * window_size_ + kExtraSaveSamples;
+  return std::min(sample_buffer_.size, save_samples);
 }
 
 FileSource::FileSourceKeyframe* FileSource::getKeyframe(int index) {
@@ -127,6 +127,8 @@ class FileSource : public WavetableComponent {
     WavetableComponentFactory::ComponentType getType() override;
     json stateToJson() override;
     void jsonToState(json data) override;
+    void stateToBinary(MemoryOutputStream& stream) override;
+    bool binaryToState(MemoryInputStream& stream) override;
 
     FileSourceKeyframe* getKeyframe(int index);
     const SampleBuffer* buffer() const { return &sample_buffer_; }
@@ -153,6 +155,12 @@ class FileSource : public WavetableComponent {
     force_inline const float* getCubicInterpolationBuffer() { return sample_buffer_.data.get(); }
 
   protected:
+    // The JSON state without the audio, and how many samples of the audio
+    // the keyframes reach and get saved.
+    json parametersToJson();
+    void jsonToParameters(json data);
+    int numSaveSamples();
+
     FileSourceKeyframe compute_frame_;
     WaveSourceKeyframe interpolate_from_frame_;
     WaveSourceKeyframe interpolate_to_frame_;
@@ -53,6 +53,46 @@ void WaveSource::jsonToState(json data) {
   compute_frame_->setInterpolationMode(interpolation_mode_);
 }
 
+void WaveSource::stateToBinary(MemoryOutputStream& stream) {
+  stream.writeInt(interpolation_style_);
+  stream.writeInt(interpolation_mode_);
+  stream.writeInt(numFrames());
+  for (int i = 0; i < numFrames(); ++i) {
+    stream.writeInt(keyframes_[i]->position());
+    stream.write(getWaveFrame(i)->time_domain, sizeof(float) * vital::WaveFrame::kWaveformSize);
+  }
+}
+
+bool WaveSource::binaryToState(MemoryInputStream& stream) {
+  int interpolation_style = stream.readInt();
+  int interpolation_mode = stream.readInt();
+  int num_keyframes = stream.readInt();
+  if (interpolation_style < 0 || interpolation_style >= kNumInterpolationStyles ||
+      (interpolation_mode != kTime && interpolation_mode != kFrequency) ||
+      num_keyframes < 0 || num_keyframes > vital::kNumOscillatorWaveFrames) {
+    return false;
+  }
+
+  keyframes_.clear();
+  for (int i = 0; i < num_keyframes; ++i) {
+    int position = stream.readInt();
+    if (position < 0 || position >= vital::kNumOscillatorWaveFrames)
+      return false;
+
+    WaveSourceKeyframe* keyframe = dynamic_cast<WaveSourceKeyframe*>(insertNewKeyframe(position));
+    vital::WaveFrame* wave_frame = keyframe->wave_frame();
+    int num_bytes = sizeof(float) * vital::WaveFrame::kWaveformSize;
+    if (stream.read(wave_frame->time_domain, num_bytes) != num_bytes)
+      return false;
+    wave_frame->toFrequencyDomain();
+  }
+
+  interpolation_style_ = static_cast<InterpolationStyle>(interpolation_style);
+  interpolation_mode_ = static_cast<InterpolationMode>(interpolation_mode);
+  compute_frame_->setInterpolationMode(interpolation_mode_);
+  return true;
+}
+
 vital::WaveFrame* WaveSource::getWaveFrame(int index) {
   return getKeyframe(index)->wave_frame();
 }
@@ -37,6 +37,8 @@ class WaveSource : public WavetableComponent {
     virtual WavetableComponentFactory::ComponentType getType() override;
     virtual json stateToJson() override;
     virtual void jsonToState(json data) override;
+    virtual void stateToBinary(MemoryOutputStream& stream) override;
+    virtual bool binaryToState(MemoryInputStream& stream) override;
 
     vital::WaveFrame* getWaveFrame(int index);
     WaveSourceKeyframe* getKeyframe(int index);
@@ -65,6 +65,36 @@ json WavetableComponent::stateToJson() {
   };
 }
 
+void WavetableComponent::stateToBinary(MemoryOutputStream& stream) {
+  writeJsonBinary(stream, stateToJson());
+}
+
+bool WavetableComponent::binaryToState(MemoryInputStream& stream) {
+  json data;
+  if (!readJsonBinary(stream, data))
+    return false;
+
+  jsonToState(data);
+  return true;
+}
+
+void WavetableComponent::writeJsonBinary(MemoryOutputStream& stream, const json& data) {
+  std::vector<uint8_t> cbor = json::to_cbor(data);
+  stream.writeInt(static_cast<int>(cbor.size()));
+  stream.write(cbor.data(), cbor.size());
+}
+
+bool WavetableComponent::readJsonBinary(MemoryInputStream& stream, json& data) {
+  int size = stream.readInt();
+  if (size < 0 || size > stream.getNumBytesRemaining())
+    return false;
+
+  std::vector<uint8_t> cbor(size);
+  stream.read(cbor.data(), size);
+  data = json::from_cbor(cbor);
+  return data.is_object();
+}
+
 void WavetableComponent::reset() {
   keyframes_.clear();
   insertNewKeyframe(0);
@@ -44,6 +44,10 @@ class WavetableComponent {
     virtual WavetableComponentFactory::ComponentType getType() = 0;
     virtual json stateToJson();
     virtual void jsonToState(json data);
+    // Used by WavetableGroup's binary state. Stores the JSON state as CBOR
+    // unless a component has audio to store raw.
+    virtual void stateToBinary(MemoryOutputStream& stream);
+    virtual bool binaryToState(MemoryInputStream& stream);
     virtual void prerender() { }
     virtual bool hasKeyframes() { return true; }
 
@@ -70,6 +74,9 @@ class WavetableComponent {
     InterpolationStyle getInterpolationStyle() const { return interpolation_style_; }
   
   protected:
+    static void writeJsonBinary(MemoryOutputStream& stream, const json& data);
+    static bool readJsonBinary(MemoryInputStream& stream, json& data);
+
     std::vector<std::unique_ptr<WavetableKeyframe>> keyframes_;
     InterpolationStyle interpolation_style_;
 
@@ -462,6 +462,70 @@ json WavetableCreator::updateJson(json data) {
   return data;
 }
 
+void WavetableCreator::copy(const WavetableCreator* other) {
+  clear();
+  remove_all_dc_ = other->remove_all_dc_;
+  full_normalize_ = other->full_normalize_;
+  last_file_loaded_ = other->last_file_loaded_;
+
+  for (auto& group : other->groups_) {
+    MemoryOutputStream group_state;
+    group->stateToBinary(group_state);
+    MemoryInputStream group_stream(group_state.getData(), group_state.getDataSize(), false);
+    WavetableGroup* new_group = new WavetableGroup();
+    // A group always reads back the state it just wrote.
+    bool loaded = new_group->binaryToState(group_stream);
+    VITAL_ASSERT(loaded);
+    UNUSED(loaded);
+    addGroup(new_group);
+  }
+
+  wavetable_->copy(other->wavetable_);
+}
+
+void WavetableCreator::takeFrom(WavetableCreator* other) {
+  remove_all_dc_ = other->remove_all_dc_;
+  full_normalize_ = other->full_normalize_;
+  last_file_loaded_ = other->last_file_loaded_;
+  groups_ = std::move(other->groups_);
+  other->groups_.clear();
+
+  wavetable_->copy(other->wavetable_);
+}
+
+void WavetableCreator::stateToBinary(MemoryOutputStream& stream) {
+  stream.writeString(wavetable_->getName());
+  stream.writeString(wavetable_->getAuthor());
+  stream.writeBool(remove_all_dc_);
+  stream.writeBool(full_normalize_);
+
+  stream.writeInt(numGroups());
+  for (auto& group : groups_)
+    group->stateToBinary(stream);
+}
+
+bool WavetableCreator::binaryToState(MemoryInputStream& stream) {
+  clear();
+  wavetable_->setName(stream.readString().toStdString());
+  wavetable_->setAuthor(stream.readString().toStdString());
+  remove_all_dc_ = stream.readBool();
+  full_normalize_ = stream.readBool();
+
+  int num_groups = stream.readInt();
+  if (num_groups < 0 || num_groups > stream.getNumBytesRemaining())
+    return false;
+
+  for (int i = 0; i < num_groups; ++i) {
+    std::unique_ptr<WavetableGroup> group = std::make_unique<WavetableGroup>();
+    if (!group->binaryToState(stream))
+      return false;
+    groups_.push_back(std::move(group));
+  }
+
+  render();
+  return true;
+}
+
 json WavetableCreator::stateToJson() {
   json json_groups;
   for (auto& group : groups_)
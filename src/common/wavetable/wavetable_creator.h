@@ -73,6 +73,19 @@ class WavetableCreator {
     json stateToJson();
     void jsonToState(json data);
 
+    // Binary counterparts of stateToJson and jsonToState for the compact synth
+    // state. Keyframe and file audio is stored raw. binaryToState renders the
+    // wavetable and returns false if stream doesn't hold a valid state.
+    void stateToBinary(MemoryOutputStream& stream);
+    bool binaryToState(MemoryInputStream& stream);
+
+    // Takes over other's groups and its rendered wavetable without rendering
+    // again. The groups go through their binary state.
+    void copy(const WavetableCreator* other);
+    // Like copy, but moves other's groups over instead of duplicating them.
+    // Leaves other without groups.
+    void takeFrom(WavetableCreator* other);
+
     vital::Wavetable* getWavetable() { return wavetable_; }
 
   protected:
@@ -130,3 +130,32 @@ void WavetableGroup::jsonToState(json data) {
     addComponent(component);
   }
 }
+
+void WavetableGroup::stateToBinary(MemoryOutputStream& stream) {
+  stream.writeInt(numComponents());
+  for (auto& component : components_) {
+    stream.writeInt(component->getType());
+    component->stateToBinary(stream);
+  }
+}
+
+bool WavetableGroup::binaryToState(MemoryInputStream& stream) {
+  components_.clear();
+
+  int num_components = stream.readInt();
+  if (num_components < 0 || num_components > stream.getNumBytesRemaining())
+    return false;
+
+  for (int i = 0; i < num_components; ++i) {
+    int type = stream.readInt();
+    if (type < 0 || type >= WavetableComponentFactory::numComponentTypes())
+      return false;
+
+    WavetableComponentFactory::ComponentType component_type = static_cast<WavetableComponentFactory::ComponentType>(type);
+    std::unique_ptr<WavetableComponent> component(WavetableComponentFactory::createComponent(component_type));
+    if (!component->binaryToState(stream))
+      return false;
+    addComponent(component.release());
+  }
+  return true;
+}
@@ -48,6 +48,8 @@ class WavetableGroup {
 
     json stateToJson();
     void jsonToState(json data);
+    void stateToBinary(MemoryOutputStream& stream);
+    bool binaryToState(MemoryInputStream& stream);
 
   protected:
     vital::WaveFrame compute_frame_;
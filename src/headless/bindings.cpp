@@ -5,11 +5,17 @@
 #include <nanobind/stl/map.h>
 #include <nanobind/stl/array.h>
 #include <nanobind/stl/list.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/shared_ptr.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/unique_ptr.h>
+#include <nanobind/stl/vector.h>
 
 #include "compressor.h"
+#include "dataset_writer.h"
 #include "processor_router.h"
 #include "random_lfo.h"
+#include "render_pool.h"
 #include "sound_engine.h"
 #include "synth_base.h"
 #include "synth_filter.h"
@@ -22,9 +28,14 @@
 #include "synth_parameters.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <string>
 #include <vector>
 
+#if defined(__x86_64__) && JUCE_LINUX
+#include <dlfcn.h>
+#endif
+
 namespace nb = nanobind;
 using namespace vital;
 
@@ -146,16 +157,24 @@ static std::string get_control_text(HeadlessSynth &synth, const std::string &nam
     return std::to_string(display_val) + details.display_units;
 }
 
-// Wrapper class for Value that knows its parameter name
+// Control for a parameter ID, checked because IDs come straight from Python.
+static vital::Value* controlById(HeadlessSynth &synth, int id) {
+    const auto &controls = synth.getControlTable();
+    if (id < 0 || id >= static_cast<int>(controls.size()) || controls[id] == nullptr)
+        throw std::out_of_range("No control with ID " + std::to_string(id) + ".");
+    return controls[id];
+}
+
+// Wrapper class for Value that knows its parameter
 class ControlValue {
 private:
     vital::Value* value_;
-    std::string name_;
+    const ValueDetails* details_;
     HeadlessSynth* synth_;
 
 public:
-    ControlValue(vital::Value* value, const std::string& name, HeadlessSynth* synth)
-        : value_(value), name_(name), synth_(synth) {}
+    ControlValue(vital::Value* value, int id, HeadlessSynth* synth)
+        : value_(value), details_(Parameters::getDetails(id)), synth_(synth) {}
 
     // Delegate existing Value methods
     float value() const { return value_->value(); }
@@ -164,120 +183,63 @@ public:
     
     // Normalized control methods
     void set_normalized(double normalized) {
-        // Clamp to 0-1
-        normalized = std::max(0.0, std::min(1.0, normalized));
-        
-        const auto &details = Parameters::getDetails(name_);
-        float value;
-        
-        if (details.value_scale == ValueDetails::kIndexed) {
-            // For indexed parameters, quantize to discrete values
-            int num_options = static_cast<int>(details.max - details.min + 1);
-            int index = static_cast<int>(std::round(normalized * (num_options - 1)));
-            value = details.min + index;
-        } else {
-            // For non-linear parameters, normalized represents the display position
-            // We need to convert: normalized -> display value -> internal value
-            float value_normalized = static_cast<float>(normalized);
-            
-            switch (details.value_scale) {
-            case ValueDetails::kQuadratic:
-                // Display = internal^2, so internal = sqrt(display)
-                // normalized maps to display range
-                value = details.min + std::sqrt(value_normalized) * (details.max - details.min);
-                break;
-            case ValueDetails::kCubic:
-                // Display = internal^3, so internal = display^(1/3)
-                value = details.min + std::pow(value_normalized, 1.0f/3.0f) * (details.max - details.min);
-                break;
-            case ValueDetails::kQuartic: {
-                // VST behavior: knob position represents quartic of display position
-                // When knob is at 50%, we want display = 4 * 0.5^4 = 0.25 seconds
-                // Since display = internal^4 and max_display = max_internal^4
-                // We want internal = (normalized^4 * max_display)^(1/4) = normalized * max_internal
-                value = details.min + value_normalized * (details.max - details.min);
-                break;
-            }
-            case ValueDetails::kExponential:
-                // For exponential, normalized maps directly to the exponent
-                if (details.display_invert)
-                    value = details.min + (1.0f / std::pow(2.0f, value_normalized)) * (details.max - details.min);
-                else
-                    value = details.min + std::pow(2.0f, value_normalized) * (details.max - details.min);
-                break;
-            case ValueDetails::kSquareRoot:
-                // Display = sqrt(internal), so internal = display^2
-                value = details.min + (value_normalized * value_normalized) * (details.max - details.min);
-                break;
-            default: // Linear
-                value = details.min + value_normalized * (details.max - details.min);
-                break;
-            }
-        }
-        
-        value_->set(value);
+        value_->set(Parameters::getValueFromNormalized(*details_, static_cast<float>(normalized)));
     }
-    
+
     double get_normalized() const {
-        const auto &details = Parameters::getDetails(name_);
-        float raw = value_->value();
-        
-        if (details.value_scale == ValueDetails::kIndexed) {
-            // For indexed parameters, normalize based on index
-            int num_options = static_cast<int>(details.max - details.min + 1);
-            int index = static_cast<int>(std::round(raw - details.min));
-            return static_cast<double>(index) / (num_options - 1);
-        } else {
-            // Normalize to 0-1 range within parameter bounds
-            float normalized_internal = (raw - details.min) / (details.max - details.min);
-            float normalized;
-            
-            // Convert internal value to display position (0-1)
-            switch (details.value_scale) {
-            case ValueDetails::kQuadratic:
-                // Display = internal^2
-                normalized = normalized_internal * normalized_internal;
-                break;
-            case ValueDetails::kCubic:
-                // Display = internal^3
-                normalized = normalized_internal * normalized_internal * normalized_internal;
-                break;
-            case ValueDetails::kQuartic:
-                // VST behavior: normalized position = internal position
-                normalized = normalized_internal;
-                break;
-            case ValueDetails::kExponential:
-                // For exponential, need to account for the range
-                if (details.display_invert)
-                    normalized = -std::log2(normalized_internal + 1e-10f);
-                else
-                    normalized = std::log2(normalized_internal + 1e-10f);
-                break;
-            case ValueDetails::kSquareRoot:
-                // Display = sqrt(internal)
-                normalized = std::sqrt(normalized_internal);
-                break;
-            default: // Linear
-                normalized = normalized_internal;
-                break;
-            }
-            
-            return std::max(0.0, std::min(1.0, static_cast<double>(normalized)));
-        }
+        return Parameters::getNormalizedFromValue(*details_, value_->value());
     }
     
     std::string get_text() const {
-        return get_control_text(*synth_, name_);
+        return get_control_text(*synth_, details_->name);
     }
 };
 
-NB_MODULE(vita, m) {
+// The instruction set this build of the engine was compiled for.
+static const char *simd_backend() {
+#if VITAL_AVX2
+    return "avx2";
+#elif VITAL_NEON
+    return "neon";
+#else
+    return "sse2";
+#endif
+}
+
+static void bind_vita(nb::module_ &m) {
+
+    m.def("simd_backend", &simd_backend,
+          "The instruction set of the engine this process renders with.\n\n"
+          "On x86-64 Linux, vita ships an SSE2 engine and an AVX2 engine and\n"
+          "picks AVX2 at import when the CPU has AVX2 and FMA. Setting the\n"
+          "environment variable VITA_SIMD_BACKEND=sse2 before importing vita\n"
+          "keeps the SSE2 engine.\n"
+          "\n"
+          "Returns:\n"
+          "  str: \"sse2\", \"avx2\" or \"neon\".");
 
     m.def("get_modulation_sources", &get_modulation_sources,
 		"Returns a list of allowed modulation sources.");
 
     m.def("get_modulation_destinations", &get_modulation_destinations,
           "Returns a list of allowed modulation destinations");
+
+    m.def("parameter_names", []() {
+        nb::list result;
+        for (int id = 0; id < Parameters::getNumParameters(); ++id)
+            result.append(Parameters::getDetails(id)->name);
+        return result;
+    }, "Every parameter name in ID order.\n\n"
+       "This is the order of Synth.get_parameter_vector and\n"
+       "Synth.set_parameter_vector, and position i is the name with\n"
+       "control_id i.\n"
+       "\n"
+       "Returns:\n"
+       "  list[str]: Parameter names.");
+
+    // Synth.render_async's workers take the GIL to hand back results, so
+    // they have to be stopped while the interpreter can still run them.
+    nb::module_::import_("atexit").attr("register")(nb::cpp_function(&AsyncRenderer::shutdown));
     
     auto m_constants = m.def_submodule("constants", "Submodule containing constants and enums");
     
@@ -562,13 +524,48 @@ NB_MODULE(vita, m) {
         .def("get_text", &ControlValue::get_text,
              "Get formatted display text for the control");
     
+    nb::class_<RenderSession>(m, "RenderSession",
+        "An in-progress render that produces its audio a chunk at a time.\n\n"
+        "Returned by Synth.stream. Iterate over it to get successive float32\n"
+        "arrays shaped (2, chunk_samples); the last one may be shorter. The\n"
+        "engine keeps its state between chunks, so concatenating them gives\n"
+        "the same audio as Synth.render. Rendering anything else on the same\n"
+        "Synth, loading a preset or changing a control or modulation before\n"
+        "the stream is finished invalidates it.")
+        .def("__iter__", [](RenderSession &session) -> RenderSession & { return session; },
+             nb::rv_policy::reference)
+        .def("__next__", &RenderSession::next,
+             "Render the next chunk.\n\n"
+             "Releases the GIL while the chunk renders.\n"
+             "\n"
+             "Raises:\n"
+             "  StopIteration: Once the whole render has been returned.\n"
+             "  RuntimeError: If the Synth has rendered something else or been\n"
+             "  changed since this stream started.")
+        .def_prop_ro("chunk_samples", &RenderSession::chunkSamples,
+                     "Samples per chunk, except possibly the last.")
+        .def_prop_ro("total_samples", &RenderSession::totalSamples,
+                     "Samples in the whole render.")
+        .def_prop_ro("position", &RenderSession::position,
+                     "Samples rendered so far.");
+
+    nb::class_<RenderSnapshot>(m, "RenderSnapshot",
+        "The state of every processor in a Synth's engine after a warm-up.\n\n"
+        "Returned by Synth.snapshot and passed back to Synth.restore. It\n"
+        "holds the voices' oscillator, filter and delay state as well as the\n"
+        "effects and modulators, so it takes tens of megabytes.")
+        .def_prop_ro("warmup_samples", &RenderSnapshot::warmupSamples,
+                     "Samples the engine ran for before it was saved.")
+        .def_prop_ro("size_bytes", &RenderSnapshot::sizeInBytes,
+                     "Memory taken by the saved state.");
+
     // Expose the SynthBase class, specifying ProcessorRouter as its base
     nb::class_<HeadlessSynth>(m, "Synth",
         "A headless Vital synthesizer.\n\n"
         "A new Synth starts on the init preset. Load a different one with\n"
         "load_preset or load_json, adjust it through get_controls, then call\n"
         "render or render_file.\n\n"
-        "Give each thread its own Synth. render, render_file, load_preset,\n"
+        "Give each thread its own Synth. The render methods, load_preset,\n"
         "load_json and to_json all release the GIL, so separate instances\n"
         "render in parallel. Sharing one instance across threads is safe but\n"
         "serialized, so it gains you nothing.")
@@ -576,14 +573,53 @@ NB_MODULE(vita, m) {
                             // accordingly
                             // Bind the first overload of connectModulation
 
+        // Pickles carry the compact binary state from LoadSave::stateToBinary.
+        // Building the bytes object needs the GIL, the rest does not.
         .def("__getstate__", [](HeadlessSynth &synth) {
-               return const_cast<HeadlessSynth &>(synth).pyToJson();  // Removes const safely
+               MemoryBlock state;
+               {
+                 nb::gil_scoped_release release;
+                 state = synth.saveToBinary();
+               }
+               return nb::bytes(static_cast<const char *>(state.getData()), state.getSize());
         })
+        .def("__setstate__", [](HeadlessSynth &synth, nb::bytes state) {
+             new (&synth) HeadlessSynth();
+             const char *data = state.c_str();
+             size_t size = state.size();
+             bool loaded;
+             {
+               nb::gil_scoped_release release;
+               loaded = synth.loadFromBinary(data, size);
+             }
+             // nanobind never destroys an instance whose __setstate__ threw.
+             if (!loaded) {
+               synth.~HeadlessSynth();
+               throw std::invalid_argument("Not a Synth state from this version of vita");
+             }
+        })
+        // Pickles written before the binary state held the preset JSON.
         .def("__setstate__", [](HeadlessSynth &synth, const std::string &json) {
              new (&synth) HeadlessSynth();
-             synth.loadFromString(json);
+             if (!synth.loadFromString(json)) {
+               synth.~HeadlessSynth();
+               throw std::invalid_argument("Not a Synth preset");
+             }
         })
 
+        .def("clone", &HeadlessSynth::clone,
+             "Returns an independent copy of this synth.\n\n"
+             "Copies controls, modulations, LFO shapes, the sample, wavetables,\n"
+             "tuning, MPE mode and sample rate directly, reusing the already\n"
+             "rendered wavetable data, so it is much cheaper than a\n"
+             "to_json/load_json round trip.\n"
+             "Use it to hand a loaded preset to worker threads.\n"
+             "\n"
+             "Returns:\n"
+             "  Synth: The copy.")
+        .def("__deepcopy__", [](HeadlessSynth &synth, nb::handle) { return synth.clone(); },
+             nb::arg("memo"))
+
         .def("connect_modulation",
              nb::overload_cast<const std::string &, const std::string &>(
                  &HeadlessSynth::pyConnectModulation),
@@ -604,6 +640,23 @@ NB_MODULE(vita, m) {
              "Set the render sample rate.\n\n"
              "Parameters:\n"
              "  sample_rate (float): Samples per second, e.g. 44100.")
+        .def("set_quality", &HeadlessSynth::setQuality, nb::arg("quality").none(),
+             "Trade render quality for speed by fixing the oversampling.\n\n"
+             "Voices and effects run at the oversampled rate, so draft renders\n"
+             "take roughly half the time of normal ones. The setting outlasts\n"
+             "preset loads and is copied by clone, but is not saved with the\n"
+             "preset.\n"
+             "\n"
+             "Parameters:\n"
+             "  quality (str | None): \"draft\" for 1x, \"normal\" for 2x or\n"
+             "    \"high\" for 4x oversampling. None follows the preset's own\n"
+             "    oversampling setting again.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If quality is not one of those names.")
+        .def("get_quality", &HeadlessSynth::getQuality,
+             "Return the quality set by set_quality, or None if renders follow\n"
+             "the preset's oversampling setting.")
 
         .def("render_file", &HeadlessSynth::renderAudioToFile2,
              // The whole function is pure C++ DSP + file I/O (no Python or
@@ -613,21 +666,82 @@ NB_MODULE(vita, m) {
              nb::call_guard<nb::gil_scoped_release>(),
              nb::arg("output_path"), nb::arg("midi_note"),
              nb::arg("midi_velocity"), nb::arg("note_dur"),
-             nb::arg("render_dur"),
+             nb::arg("render_dur"), nb::kw_only(), nb::arg("bit_depth") = 16,
              "Renders audio to a file.\n\n"
+             "The file is a WAV, or FLAC if output_path ends in .flac.\n"
+             "\n"
              "Parameters:\n"
              "  output_path (str): Path to the output audio file.\n"
              "  midi_note (int): MIDI note to render.\n"
              "  midi_velocity (float): Velocity of the note [0-1].\n"
              "  note_dur (float): Length of the note sustain in seconds.\n"
              "  render_dur (float): Length of the audio render in seconds.\n"
+             "  bit_depth (int): 16 or 24 for integer samples, or 32 for float\n"
+             "    samples, which only WAV supports.\n"
              "\n"
              "Returns:\n"
-             "  bool: True if rendering was successful, False otherwise.")
+             "  bool: True if rendering was successful, False otherwise.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If bit_depth is not supported for the file type.")
+        .def("render_files", [](HeadlessSynth &synth,
+                                const std::vector<std::tuple<std::string, int, float, float, float>> &jobs,
+                                int bit_depth) {
+               std::vector<HeadlessSynth::FileRenderJob> file_jobs;
+               for (const auto &[output_path, midi_note, velocity, note_dur, render_dur] : jobs)
+                   file_jobs.push_back({ output_path, midi_note, velocity, note_dur, render_dur });
 
-        .def("render", &HeadlessSynth::renderAudioToNumpy, nb::arg("midi_note"),
+               nb::gil_scoped_release gil_release;
+               return synth.renderAudioToFiles(file_jobs, bit_depth);
+             },
+             nb::arg("jobs"), nb::kw_only(), nb::arg("bit_depth") = 16,
+             "Renders several notes to files, writing each file while the next renders.\n\n"
+             "Equivalent to calling render_file once per job, but the synth is\n"
+             "locked once and the files are encoded and written on a separate\n"
+             "thread, so disk time overlaps with rendering.\n"
+             "\n"
+             "Parameters:\n"
+             "  jobs (list[tuple[str, int, float, float, float]]): One\n"
+             "    (output_path, midi_note, midi_velocity, note_dur, render_dur)\n"
+             "    per file, as for render_file.\n"
+             "  bit_depth (int): As for render_file, for every file.\n"
+             "\n"
+             "Returns:\n"
+             "  list[bool]: Whether each file was written.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If bit_depth is not supported for any of the files.\n"
+             "    Nothing is rendered in that case.")
+
+        .def("render", [](HeadlessSynth &synth, int midi_note, float velocity, float note_dur,
+                          float render_dur, bool trim_tail, float tail_threshold_db, float tail_hold,
+                          std::optional<std::vector<std::string>> stems,
+                          std::optional<std::vector<std::string>> capture,
+                          nb::object dtype, bool dither, uint32_t dither_seed) -> nb::object {
+            // Anything numpy.dtype accepts: "int16", np.int16, np.dtype("int16").
+            HeadlessSynth::SampleFormat format = HeadlessSynth::kFloat32;
+            if (!dtype.is_none()) {
+                nb::object name = nb::module_::import_("numpy").attr("dtype")(dtype).attr("name");
+                format = HeadlessSynth::sampleFormatFromName(nb::cast<std::string>(name));
+            }
+
+            if (!stems && !capture)
+                return nb::cast(synth.renderAudioToNumpy(midi_note, velocity, note_dur, render_dur,
+                                                         trim_tail, tail_threshold_db, tail_hold,
+                                                         format, dither, dither_seed));
+            if (trim_tail)
+                throw std::invalid_argument("trim_tail cannot be combined with stems or capture.");
+            if (format != HeadlessSynth::kFloat32 || dither)
+                throw std::invalid_argument("stems and capture are only rendered as float32.");
+            return synth.renderTappedToNumpy(midi_note, velocity, note_dur, render_dur, stems,
+                                             capture.value_or(std::vector<std::string>()));
+        }, nb::arg("midi_note"),
              nb::arg("midi_velocity"), nb::arg("note_dur"),
-             nb::arg("render_dur"),
+             nb::arg("render_dur"), nb::kw_only(), nb::arg("trim_tail") = false,
+             nb::arg("tail_threshold_db") = HeadlessSynth::kDefaultTailThresholdDb,
+             nb::arg("tail_hold") = HeadlessSynth::kDefaultTailHold,
+             nb::arg("stems") = nb::none(), nb::arg("capture") = nb::none(),
+             nb::arg("dtype") = nb::none(), nb::arg("dither") = false, nb::arg("dither_seed") = 0,
              "Renders audio to a NumPy array.\n\n"
              "Releases the GIL during the render, so threads that each own a\n"
              "separate Synth render in parallel.\n"
@@ -637,9 +751,274 @@ NB_MODULE(vita, m) {
              "  midi_velocity (float): Velocity of the note [0-1].\n"
              "  note_dur (float): Length of the note sustain in seconds.\n"
              "  render_dur (float): Length of the audio render in seconds.\n"
+             "  trim_tail (bool): Stop rendering once the note has been released\n"
+             "    and the output has stayed below tail_threshold_db for\n"
+             "    tail_hold seconds. The returned array is then shorter.\n"
+             "  tail_threshold_db (float): Peak level treated as silence.\n"
+             "  tail_hold (float): How long the output must stay silent, in\n"
+             "    seconds.\n"
+             "  stems (list[str] | None): Return these separate signals from the\n"
+             "    one render instead of the mixed output: \"osc_1\" to \"osc_3\"\n"
+             "    and \"sample\" after the amplitude envelope but before filters\n"
+             "    and effects, \"dry\" and \"wet\" for the effect chain's input\n"
+             "    and output, and \"mix\" for the normal output. Direct-out\n"
+             "    sources appear in mix and their own stem but not in dry or wet.\n"
+             "  capture (list[str] | None): Also record these once per 64-sample\n"
+             "    block: modulation sources and other status outputs such as\n"
+             "    \"lfo_1\", \"env_1\" or \"random_1\", or modulation destinations\n"
+             "    such as \"filter_1_cutoff\", recorded as their modulated value\n"
+             "    in the control's plain units. Each gives a float32 array shaped\n"
+             "    (num_blocks, 2) holding the left and right lanes of the most\n"
+             "    recently played voice, and NaN for a per-voice source in\n"
+             "    blocks where no voice is playing.\n"
+             "  dtype (str | numpy.dtype | None): float32 (the default), int16\n"
+             "    or float16. Other types are converted as the audio leaves the\n"
+             "    engine, so no float32 copy is made. int16 maps full scale to\n"
+             "    32767 and clips beyond it.\n"
+             "  dither (bool): Add TPDF dither of one step before rounding to\n"
+             "    int16. Only valid with dtype int16.\n"
+             "  dither_seed (int): Seeds the dither noise. The same seed gives\n"
+             "    the same output on any synth or thread.\n"
              "\n"
              "Returns:\n"
-             "  numpy.ndarray: float32 array shaped (2, render_dur * sample_rate).")
+             "  numpy.ndarray: array of dtype shaped (2, render_dur * sample_rate),\n"
+             "  or (2, n) with n at most that when trim_tail is set. With stems,\n"
+             "  (len(stems), 2, render_dur * sample_rate). With capture, a tuple\n"
+             "  of that array and a dict mapping each captured name to its array.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If a stem or capture name is unknown, stems or\n"
+             "  capture is combined with trim_tail or a dtype other than\n"
+             "  float32, dtype is not supported, or dither is set without\n"
+             "  int16.")
+
+        .def("render_into", &HeadlessSynth::renderAudioIntoNumpy,
+             // noconvert: without it nanobind would quietly copy a float64 or
+             // non-contiguous array into a temporary and render into that.
+             nb::arg("out").noconvert(), nb::arg("midi_note"),
+             nb::arg("midi_velocity"), nb::arg("note_dur"),
+             "Renders audio into an existing NumPy array.\n\n"
+             "Nothing is allocated or copied: the audio is written straight\n"
+             "into out, which may be a view into a larger array such as a\n"
+             "memory-mapped dataset. The render length is taken from its shape.\n"
+             "Releases the GIL during the render.\n"
+             "\n"
+             "Parameters:\n"
+             "  out (numpy.ndarray): C-contiguous float32 array shaped either\n"
+             "    (2, num_samples) for planar or (num_samples, 2) for\n"
+             "    interleaved stereo. A (2, 2) array is treated as planar.\n"
+             "  midi_note (int): MIDI note to render.\n"
+             "  midi_velocity (float): Velocity of the note [0-1].\n"
+             "  note_dur (float): Length of the note sustain in seconds.\n"
+             "\n"
+             "Raises:\n"
+             "  TypeError: If out is not a C-contiguous float32 array with two\n"
+             "  dimensions.\n"
+             "  ValueError: If neither dimension of out is 2.")
+
+        .def("render_async", &AsyncRenderer::submit, nb::arg("midi_note"), nb::arg("midi_velocity"),
+             nb::arg("note_dur"), nb::arg("render_dur"),
+             "Starts a render on a native worker thread and returns an awaitable.\n\n"
+             "The render runs on a small pool of C++ threads shared by every\n"
+             "Synth, so an event loop can keep many renders in flight without a\n"
+             "Python thread for each. Renders of different synths run in\n"
+             "parallel; renders of the same synth take turns. Cancelling the\n"
+             "future drops the result but does not stop the render.\n"
+             "\n"
+             "Parameters:\n"
+             "  midi_note (int): MIDI note number.\n"
+             "  midi_velocity (float): Velocity [0-1].\n"
+             "  note_dur (float): Length of the note sustain in seconds.\n"
+             "  render_dur (float): Length of the render in seconds.\n"
+             "\n"
+             "Returns:\n"
+             "  asyncio.Future: Completes on the running event loop with a\n"
+             "  float32 array shaped (2, render_dur * sample_rate), as from\n"
+             "  render.\n"
+             "\n"
+             "Raises:\n"
+             "  RuntimeError: If called without a running event loop. A failed\n"
+             "    render sets RuntimeError on the future instead.")
+
+        .def("render_batch", &HeadlessSynth::renderBatchToNumpy, nb::arg("midi_notes"),
+             nb::arg("midi_velocities"), nb::arg("note_durs"),
+             nb::arg("render_dur"), nb::kw_only(), nb::arg("trim_tail") = false,
+             nb::arg("tail_threshold_db") = HeadlessSynth::kDefaultTailThresholdDb,
+             nb::arg("tail_hold") = HeadlessSynth::kDefaultTailHold,
+             "Renders several notes, one after another, into a single array.\n\n"
+             "Equivalent to calling render once per note and stacking the\n"
+             "results, but the GIL is released and the synth locked only once,\n"
+             "and all the audio is written into one allocation.\n"
+             "\n"
+             "Parameters:\n"
+             "  midi_notes (list[int]): MIDI notes to render, one per item.\n"
+             "  midi_velocities (list[float]): Velocities [0-1], either one per\n"
+             "    note or a single value used for every note.\n"
+             "  note_durs (list[float]): Note sustain lengths in seconds, either\n"
+             "    one per note or a single value used for every note.\n"
+             "  render_dur (float): Length of each render in seconds.\n"
+             "  trim_tail (bool): As for render, but an item that stops early is\n"
+             "    padded with zeros so every item keeps the same length.\n"
+             "  tail_threshold_db (float): Peak level treated as silence.\n"
+             "  tail_hold (float): How long the output must stay silent, in\n"
+             "    seconds.\n"
+             "\n"
+             "Returns:\n"
+             "  numpy.ndarray: float32 array shaped\n"
+             "  (len(midi_notes), 2, render_dur * sample_rate).\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If midi_velocities or note_durs has neither one\n"
+             "  entry nor one per note.")
+
+        .def("render_sweep", &HeadlessSynth::renderSweepToNumpy,
+             nb::arg("control_names"), nb::arg("value_grid"), nb::arg("midi_note"),
+             nb::arg("midi_velocity"), nb::arg("note_dur"), nb::arg("render_dur"),
+             nb::kw_only(), nb::arg("num_threads") = 1,
+             "Renders one note for every point of a grid of control values.\n\n"
+             "Each row of value_grid sets the named controls, without smoothing\n"
+             "in from the previous row's values, the voices are reset and the\n"
+             "note is rendered, all in C++ on the loaded preset. The result\n"
+             "doesn't depend on num_threads. The controls are put back\n"
+             "afterwards. Build a full grid over two\n"
+             "controls with, for example, np.stack(np.meshgrid(a, b), -1)\n"
+             ".reshape(-1, 2).\n"
+             "\n"
+             "Parameters:\n"
+             "  control_names (list[str]): Controls to set, one per column.\n"
+             "  value_grid (np.ndarray): float32 array shaped\n"
+             "    (num_points, len(control_names)) of plain control values.\n"
+             "  midi_note (int): MIDI note to render.\n"
+             "  midi_velocity (float): Velocity of the note [0-1].\n"
+             "  note_dur (float): Length of the note sustain in seconds.\n"
+             "  render_dur (float): Length of each render in seconds.\n"
+             "  num_threads (int): Split the grid across this many threads,\n"
+             "    each extra one rendering on a clone of this synth.\n"
+             "\n"
+             "Returns:\n"
+             "  np.ndarray: float32 array shaped\n"
+             "  (num_points, 2, render_dur * sample_rate).\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If a control name is unknown, value_grid does not\n"
+             "  have one column per control, or num_threads is not positive.")
+
+        .def("render_events", &HeadlessSynth::renderEventsToNumpy,
+             nb::arg("events"), nb::arg("render_dur"),
+             "Renders a sequence of MIDI events to a NumPy array.\n\n"
+             "Events are applied at their exact sample position, so phrases,\n"
+             "chords, pitch bends, mod wheel moves, sustain pedal and MPE all\n"
+             "render in one call. Releases the GIL during the render.\n"
+             "\n"
+             "Parameters:\n"
+             "  events (list[tuple[float, int, int, int]]): (time, status,\n"
+             "    data1, data2) tuples. time is in seconds from the start of\n"
+             "    the render; status and the data bytes form a MIDI channel\n"
+             "    message, e.g. (0.0, 0x90, 60, 100) for a note on at middle C\n"
+             "    on channel 1, (0.5, 0xE0, 0, 96) for a pitch bend or\n"
+             "    (0.5, 0xB0, 64, 127) to press the sustain pedal.\n"
+             "  render_dur (float): Length of the audio render in seconds.\n"
+             "\n"
+             "Returns:\n"
+             "  numpy.ndarray: float32 array shaped (2, render_dur * sample_rate).\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If an event is not a valid channel message or has a\n"
+             "  negative time.")
+
+        .def("render_midi_file", &HeadlessSynth::renderMidiFileToNumpy,
+             nb::arg("path"), nb::arg("render_dur") = nb::none(),
+             "Renders a standard MIDI file to a NumPy array.\n\n"
+             "Every track is played on this Synth with sample-accurate timing\n"
+             "and the file's tempo map applied. Releases the GIL during the\n"
+             "render.\n"
+             "\n"
+             "Parameters:\n"
+             "  path (str): Path to a .mid file.\n"
+             "  render_dur (float | None): Length of the audio render in\n"
+             "    seconds. Defaults to the time of the last event plus two\n"
+             "    seconds for release tails.\n"
+             "\n"
+             "Returns:\n"
+             "  numpy.ndarray: float32 array shaped (2, render_dur * sample_rate).\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If there is no file at path.\n"
+             "  RuntimeError: If the file is not a readable MIDI file.")
+
+        .def("set_mpe_enabled", &HeadlessSynth::setMpeEnabled, nb::arg("enabled"),
+             "Treat incoming MIDI as MPE.\n\n"
+             "With MPE enabled, pitch bend, pressure and slide sent on a note's\n"
+             "own channel apply to that note alone. Affects render_events and\n"
+             "render_midi_file.\n"
+             "\n"
+             "Parameters:\n"
+             "  enabled (bool): Whether MPE is enabled. Off by default.")
+
+        .def("stream", &HeadlessSynth::startRenderSession,
+             // The session points back at this Synth, so keep it alive.
+             nb::keep_alive<0, 1>(),
+             nb::arg("midi_note"), nb::arg("midi_velocity"), nb::arg("note_dur"),
+             nb::arg("render_dur"), nb::arg("chunk_blocks") = 1024,
+             "Renders audio incrementally, a chunk at a time.\n\n"
+             "Only one chunk is held in memory at once, and the first is\n"
+             "available as soon as it has rendered, which suits long renders\n"
+             "that feed an encoder or feature extractor.\n"
+             "\n"
+             "Parameters:\n"
+             "  midi_note (int): MIDI note to render.\n"
+             "  midi_velocity (float): Velocity of the note [0-1].\n"
+             "  note_dur (float): Length of the note sustain in seconds.\n"
+             "  render_dur (float): Length of the audio render in seconds.\n"
+             "  chunk_blocks (int): Chunk length in 64-sample processing blocks.\n"
+             "\n"
+             "Returns:\n"
+             "  RenderSession: Iterator over float32 arrays shaped (2, n).\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If chunk_blocks is not positive.")
+
+        .def("snapshot", &HeadlessSynth::takeRenderSnapshot,
+             nb::arg("warmup_samples") = HeadlessSynth::kRenderPreProcessSamples,
+             "Warms the engine up and saves the state of every processor.\n\n"
+             "Resets the voices and runs the engine for warmup_samples, as a\n"
+             "render does before its note, then saves the oscillator, filter,\n"
+             "effect and modulator state. Until a control, a modulation or the\n"
+             "preset changes, every render restores this state instead of\n"
+             "running its own warm-up, so each note starts from the same settled\n"
+             "engine whatever was rendered before. The default length is the\n"
+             "warm-up renders run themselves; a longer one lets slow modulators\n"
+             "settle further. A restore copies the whole state back, which takes\n"
+             "tens of milliseconds: more than the default warm-up, but less than\n"
+             "a warm-up of a second on a patch with its effects on. Releases the\n"
+             "GIL.\n"
+             "\n"
+             "Parameters:\n"
+             "  warmup_samples (int): Samples to run the engine for first.\n"
+             "\n"
+             "Returns:\n"
+             "  RenderSnapshot: The saved state, also made the active snapshot.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If warmup_samples is negative.")
+
+        .def("restore", &HeadlessSynth::restoreRenderSnapshot, nb::arg("snapshot"),
+             "Puts the engine back as snapshot saved it.\n\n"
+             "Control values go back to the ones the snapshot was taken with,\n"
+             "and the snapshot becomes the one renders start from. Releases the\n"
+             "GIL.\n"
+             "\n"
+             "Parameters:\n"
+             "  snapshot (RenderSnapshot): A snapshot taken by this Synth.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If snapshot was taken by another Synth.\n"
+             "  RuntimeError: If a preset was loaded, the quality set, or the\n"
+             "  modulations, wavetables or sample rate changed since.")
+
+        .def("clear_snapshot", &HeadlessSynth::clearRenderSnapshot,
+             "Stops renders from starting at the active snapshot, so they run\n"
+             "their own warm-up again.")
 
         // load_json / to_json / load_preset only parse or serialize JSON and
         // mutate C++/Vital state -- no Python or nanobind objects touched while
@@ -677,9 +1056,10 @@ NB_MODULE(vita, m) {
              "Disconnect every modulation, leaving other controls untouched.")
         .def("get_controls", [](HeadlessSynth &synth) {
             nb::dict result;
-            auto &controls = synth.getControls();
-            for (const auto &[name, value] : controls) {
-                result[name.c_str()] = ControlValue(value, name, &synth);
+            const auto &controls = synth.getControlTable();
+            for (int id = 0; id < static_cast<int>(controls.size()); ++id) {
+                if (controls[id])
+                    result[Parameters::getDetails(id)->name.c_str()] = ControlValue(controls[id], id, &synth);
             }
             return result;
         }, nb::rv_policy::reference_internal,
@@ -687,6 +1067,101 @@ NB_MODULE(vita, m) {
            "Returns:\n"
            "  dict[str, ControlValue]: Live handles -- setting one takes effect\n"
            "  on this Synth immediately.")
+        .def("control_id", [](HeadlessSynth &synth, const std::string &name) {
+            int id = Parameters::getIndex(name);
+            if (id < 0 || synth.getControl(id) == nullptr)
+                throw std::invalid_argument("No control named " + name + ".");
+            return id;
+        }, nb::arg("name"),
+           "Get the integer ID of a control.\n\n"
+           "IDs are indices into the parameter list, the same for every Synth\n"
+           "in a process. Look one up once, then use get_by_id and set_by_id\n"
+           "to skip the name lookup when setting many values.\n"
+           "\n"
+           "Parameters:\n"
+           "  name (str): Control name, e.g. \"filter_1_cutoff\".\n"
+           "\n"
+           "Returns:\n"
+           "  int: The control's ID.\n"
+           "\n"
+           "Raises:\n"
+           "  ValueError: If no control has that name.")
+        .def("get_by_id", [](HeadlessSynth &synth, int id) {
+            return controlById(synth, id)->value();
+        }, nb::arg("id"),
+           "Get a control's value by ID.\n\n"
+           "Parameters:\n"
+           "  id (int): ID from control_id.\n"
+           "\n"
+           "Returns:\n"
+           "  float: The control's plain value.\n"
+           "\n"
+           "Raises:\n"
+           "  IndexError: If id is not a control ID.")
+        .def("set_by_id", [](HeadlessSynth &synth, int id, float value) {
+            controlById(synth, id)->set(value);
+        }, nb::arg("id"), nb::arg("value"),
+           "Set a control's value by ID.\n\n"
+           "Parameters:\n"
+           "  id (int): ID from control_id.\n"
+           "  value (float): Plain control value.\n"
+           "\n"
+           "Raises:\n"
+           "  IndexError: If id is not a control ID.")
+        .def("get_parameter_vector", &HeadlessSynth::getParameterVector,
+             nb::kw_only(), nb::arg("normalized") = true,
+             "Get every parameter's value as one array.\n\n"
+             "Parameters:\n"
+             "  normalized (bool): Return 0-1 knob positions, as\n"
+             "    ControlValue.get_normalized does, instead of plain values.\n"
+             "\n"
+             "Returns:\n"
+             "  np.ndarray: float32 array in vita.parameter_names() order.\n"
+             "  Parameters this Synth has no control for hold their default.")
+        .def("set_parameter_vector", &HeadlessSynth::setParameterVector,
+             nb::arg("values"), nb::kw_only(), nb::arg("normalized") = true,
+             "Set every parameter from one array.\n\n"
+             "The whole vector is converted in C++ and applied under a single\n"
+             "lock, with the GIL released.\n"
+             "\n"
+             "Parameters:\n"
+             "  values (np.ndarray): float32 array in vita.parameter_names()\n"
+             "    order.\n"
+             "  normalized (bool): Treat values as 0-1 knob positions, as\n"
+             "    ControlValue.set_normalized does, instead of plain values.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If values does not have one entry per parameter.")
+        .def("randomize", [](HeadlessSynth &synth, uint64_t seed,
+                             std::optional<std::vector<std::string>> include,
+                             std::optional<std::vector<std::string>> exclude,
+                             const std::string &distribution, int modulations) {
+            synth.randomize(seed, include.value_or(std::vector<std::string>()),
+                            exclude.value_or(std::vector<std::string>()), distribution, modulations);
+        }, nb::arg("seed"), nb::arg("include") = nb::none(), nb::arg("exclude") = nb::none(),
+           nb::arg("distribution") = "uniform_normalized", nb::kw_only(), nb::arg("modulations") = 0,
+           "Randomize controls, and optionally the modulation routing, in C++.\n\n"
+           "Indexed controls pick one of their options uniformly. The same seed\n"
+           "on the same starting state always gives the same result.\n"
+           "\n"
+           "Parameters:\n"
+           "  seed (int): Seed for the random generator.\n"
+           "  include (list[str] | None): Controls to randomize, as names or\n"
+           "    patterns with * and ? wildcards, e.g. \"filter_1_*\". None\n"
+           "    means every control.\n"
+           "  exclude (list[str] | None): Names or patterns to leave alone.\n"
+           "  distribution (str): \"uniform_normalized\" draws continuous\n"
+           "    controls uniformly over the knob position, following the\n"
+           "    control's scale as set_normalized does. \"uniform\" draws\n"
+           "    uniformly over the plain value range.\n"
+           "  modulations (int): If positive, replace the modulation routing\n"
+           "    with this many random source-destination pairs drawn from\n"
+           "    get_modulation_sources() and get_modulation_destinations(),\n"
+           "    each with a random amount.\n"
+           "\n"
+           "Raises:\n"
+           "  ValueError: If a pattern matches no control, distribution is\n"
+           "  unknown, or modulations is out of range.")
         .def("get_control_details", [](HeadlessSynth &synth, const std::string &name) {
             // Validate control name
             if (!vital::Parameters::isParameter(name))
@@ -711,4 +1186,199 @@ NB_MODULE(vita, m) {
              "Returns:\n"
              "  str: The value as Vital would show it, e.g. \"Ping Pong\".")
         ;
+
+    nb::class_<RenderFuture>(m, "RenderFuture",
+        "The pending result of a RenderPool job.")
+        .def("done", &RenderFuture::done,
+             "Whether the job has finished, successfully or not.")
+        .def("result", &RenderFuture::result, nb::arg("timeout") = nb::none(),
+             "Waits for the job and returns its audio.\n\n"
+             "The GIL is released while waiting.\n"
+             "\n"
+             "Parameters:\n"
+             "  timeout (float | None): Seconds to wait. None waits forever.\n"
+             "\n"
+             "Returns:\n"
+             "  np.ndarray: float32 array shaped (len(midi_notes), 2, samples).\n"
+             "\n"
+             "Raises:\n"
+             "  TimeoutError: If the job is not done within timeout.\n"
+             "  RuntimeError: If the preset could not be loaded or the render\n"
+             "    failed.");
+
+    nb::class_<RenderPool>(m, "RenderPool",
+        "Worker threads that each own a Synth and render jobs in C++.\n\n"
+        "Jobs are queued with submit and picked up by the first free worker,\n"
+        "which loads the job's preset (skipped if it already has it loaded)\n"
+        "and renders its notes. Python is only involved in submitting jobs\n"
+        "and collecting results, so the workers run without the GIL.\n\n"
+        "Use it as a context manager, or call close, so the workers stop\n"
+        "before the interpreter exits.")
+        .def(nb::init<int, float>(), nb::arg("num_threads"), nb::arg("sample_rate") = 44100.0f,
+             "Starts the workers, each with its own Synth.\n\n"
+             "Parameters:\n"
+             "  num_threads (int): Number of worker threads.\n"
+             "  sample_rate (float): Sample rate for every worker's Synth.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If num_threads or sample_rate is not positive.")
+        .def("submit", [](RenderPool &pool, const std::string &preset, const std::vector<int> &midi_notes,
+                          float velocity, float note_dur, float render_dur, nb::object callback) {
+               return pool.submit(preset, midi_notes, velocity, note_dur, render_dur, callback);
+             },
+             nb::arg("preset"), nb::arg("midi_notes"), nb::arg("midi_velocity"), nb::arg("note_dur"),
+             nb::arg("render_dur"), nb::kw_only(), nb::arg("callback") = nb::none(),
+             "Queues a render job.\n\n"
+             "Parameters:\n"
+             "  preset (str): Path to a .vital preset, or a preset's JSON text\n"
+             "    as returned by Synth.to_json.\n"
+             "  midi_notes (list[int]): MIDI notes to render, one item each.\n"
+             "  midi_velocity (float): Velocity of every note [0-1].\n"
+             "  note_dur (float): Length of each note sustain in seconds.\n"
+             "  render_dur (float): Length of each render in seconds.\n"
+             "  callback (Callable[[RenderFuture], None] | None): Called with\n"
+             "    the future on the worker thread once the job is done.\n"
+             "    Exceptions it raises are reported as unraisable.\n"
+             "\n"
+             "Returns:\n"
+             "  RenderFuture: Handle on the job's result.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If midi_notes is empty.\n"
+             "  RuntimeError: If the pool is closed.")
+        .def("close", &RenderPool::close,
+             "Finishes the queued jobs and stops the workers.")
+        .def("__enter__", [](RenderPool &pool) -> RenderPool & { return pool; },
+             nb::rv_policy::reference)
+        .def("__exit__", [](RenderPool &pool, nb::handle, nb::handle, nb::handle) { pool.close(); },
+             nb::arg("exc_type").none(), nb::arg("exc_value").none(), nb::arg("traceback").none())
+        .def_prop_ro("num_threads", &RenderPool::numThreads,
+                     "Number of worker threads.");
+
+    nb::class_<DatasetWriter>(m, "DatasetWriter",
+        "A memory-mapped .npy file of renders, shaped (num_items, 2, samples).\n\n"
+        "Each render writes its item straight into the file, in the file's\n"
+        "dtype, with no buffer on the Python side. Threads that each own a\n"
+        "Synth can fill different items at the same time. A sidecar file,\n"
+        "path + \".done\", records which items are finished, so opening an\n"
+        "existing dataset again resumes it. Read it back with\n"
+        "numpy.load(path, mmap_mode=\"r\").")
+        .def(nb::init<const std::string &, int64_t, int, const std::string &, bool>(),
+             nb::arg("path"), nb::arg("num_items"), nb::arg("samples"), nb::arg("dtype") = "float32",
+             nb::kw_only(), nb::arg("overwrite") = false,
+             "Creates the dataset, or reopens one with the same shape and dtype.\n\n"
+             "Parameters:\n"
+             "  path (str): The .npy file.\n"
+             "  num_items (int): Number of renders the file holds.\n"
+             "  samples (int): Length of every render in samples, at the\n"
+             "    sample rate of the synths that render into it.\n"
+             "  dtype (str): \"float32\", \"int16\" or \"float16\".\n"
+             "  overwrite (bool): Replace an existing file instead of resuming.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If the arguments are invalid, or path exists with a\n"
+             "    different shape or dtype or without its sidecar.")
+        .def("render", &DatasetWriter::render,
+             nb::call_guard<nb::gil_scoped_release>(),
+             nb::arg("synth"), nb::arg("index"), nb::arg("midi_note"), nb::arg("midi_velocity"),
+             nb::arg("note_dur"),
+             "Renders one note into item index and marks it done.\n\n"
+             "Releases the GIL while rendering.\n"
+             "\n"
+             "Parameters:\n"
+             "  synth (Synth): The synth to render with.\n"
+             "  index (int): Item to write.\n"
+             "  midi_note (int): MIDI note to render.\n"
+             "  midi_velocity (float): Velocity of the note [0-1].\n"
+             "  note_dur (float): Length of the note sustain in seconds.\n"
+             "\n"
+             "Raises:\n"
+             "  IndexError: If index is out of range.\n"
+             "  RuntimeError: If the writer is closed.")
+        .def("render_batch", &DatasetWriter::renderBatch,
+             nb::call_guard<nb::gil_scoped_release>(),
+             nb::arg("synth"), nb::arg("first_index"), nb::arg("midi_notes"), nb::arg("midi_velocities"),
+             nb::arg("note_durs"),
+             "Renders several notes into consecutive items.\n\n"
+             "Parameters:\n"
+             "  synth (Synth): The synth to render with.\n"
+             "  first_index (int): Item the first note goes to.\n"
+             "  midi_notes (list[int]): MIDI notes, one per item.\n"
+             "  midi_velocities (list[float]): Velocities [0-1], one per note or\n"
+             "    a single value for every note.\n"
+             "  note_durs (list[float]): Note sustain lengths in seconds, one per\n"
+             "    note or a single value for every note.\n"
+             "\n"
+             "Raises:\n"
+             "  ValueError: If the lengths of the lists do not match.\n"
+             "  IndexError: If any item is out of range.\n"
+             "  RuntimeError: If the writer is closed.")
+        .def("is_done", &DatasetWriter::isDone, nb::arg("index"),
+             "Whether item index has been rendered.")
+        .def("pending", &DatasetWriter::pendingItems,
+             "The items not rendered yet, in order.")
+        .def_prop_ro("num_done", &DatasetWriter::numDone,
+                     "Number of items rendered so far.")
+        .def("close", &DatasetWriter::close, nb::call_guard<nb::gil_scoped_release>(),
+             "Waits for renders in progress and unmaps the files.")
+        .def("__enter__", [](DatasetWriter &writer) -> DatasetWriter & { return writer; },
+             nb::rv_policy::reference)
+        .def("__exit__", [](DatasetWriter &writer, nb::handle, nb::handle, nb::handle) {
+               nb::gil_scoped_release gil_release;
+               writer.close();
+             },
+             nb::arg("exc_type").none(), nb::arg("exc_value").none(), nb::arg("traceback").none())
+        .def_prop_ro("path", &DatasetWriter::path, "The .npy file.")
+        .def_prop_ro("num_items", &DatasetWriter::numItems, "Number of items.")
+        .def_prop_ro("samples", &DatasetWriter::samples, "Samples per item.")
+        .def_prop_ro("dtype", &DatasetWriter::dtype, "Sample type of the file.");
+}
+
+#if VITAL_AVX2
+// What the SSE2 engine calls, once it has loaded this build, to bind this
+// engine into the module it is initializing instead of its own.
+extern "C" NB_EXPORT void vita_bind_module(PyObject *module) {
+    nb::module_ m = nb::borrow<nb::module_>(module);
+    bind_vita(m);
+}
+#elif defined(__x86_64__) && JUCE_LINUX
+  #define VITA_AVX2_DISPATCH 1
+#endif
+
+#if VITA_AVX2_DISPATCH
+// libvita_avx2.so is the whole engine again, built with -mavx2 -mfma, and
+// sits next to this module. It is a separate library rather than a second
+// copy of the engine in here because the engine's lookup tables and poly
+// constants are built by static initializers, which would run AVX2 code as
+// soon as the library loaded. Returns its vita_bind_module, or nullptr when
+// this engine should be used.
+typedef void (*BindModuleFunction)(PyObject *);
+
+static BindModuleFunction load_avx2_engine() {
+    const char *requested = std::getenv("VITA_SIMD_BACKEND");
+    if (requested != nullptr && std::string(requested) == simd_backend())
+        return nullptr;
+    if (!SystemStats::hasAVX2() || !SystemStats::hasFMA3())
+        return nullptr;
+
+    File library = File::getSpecialLocation(File::currentExecutableFile).getSiblingFile("libvita_avx2.so");
+    if (!library.existsAsFile())
+        return nullptr;
+
+    // Never closed: once bound, the module's functions live in this library.
+    void *handle = dlopen(library.getFullPathName().toRawUTF8(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr)
+        return nullptr;
+    return reinterpret_cast<BindModuleFunction>(dlsym(handle, "vita_bind_module"));
+}
+#endif
+
+NB_MODULE(vita, m) {
+#if VITA_AVX2_DISPATCH
+    if (auto bind_avx2 = load_avx2_engine()) {
+        bind_avx2(m.ptr());
+        return;
+    }
+#endif
+    bind_vita(m);
 }
@@ -16,6 +16,7 @@
 
 #include "compressor.h"
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   
@@ -150,6 +151,13 @@ namespace vital {
     low_enveloped_mean_squared_ = 0.0f;
   }
 
+  void Compressor::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(input_mean_squared_, output_mean_squared_);
+    snapshot.copy(high_enveloped_mean_squared_, low_enveloped_mean_squared_);
+    snapshot.copy(mix_, output_mult_);
+    Processor::copyState(snapshot);
+  }
+
   poly_float Compressor::computeMeanSquared(const poly_float* audio_in, int num_samples, poly_float mean_squared) {
     int rms_samples = kRmsTime * getSampleRate();
     float rms_adjusted = rms_samples - 1.0f;
@@ -219,6 +227,25 @@ namespace vital {
     output(kHighOutputMeanSquared)->buffer[0] = 0.0f;
   }
 
+  void MultibandCompressor::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(was_low_enabled_, was_high_enabled_);
+
+    cr::Output* control_outputs[] = {
+      &low_band_upper_ratio_, &band_high_upper_ratio_, &low_band_lower_ratio_, &band_high_lower_ratio_,
+      &low_band_upper_threshold_, &band_high_upper_threshold_,
+      &low_band_lower_threshold_, &band_high_lower_threshold_,
+      &low_band_output_gain_, &band_high_output_gain_
+    };
+    for (cr::Output* control_output : control_outputs)
+      snapshot.copyOutput(control_output);
+
+    snapshot.copyProcessor(&low_band_filter_);
+    snapshot.copyProcessor(&band_high_filter_);
+    snapshot.copyProcessor(&low_band_compressor_);
+    snapshot.copyProcessor(&band_high_compressor_);
+    Processor::copyState(snapshot);
+  }
+
   void MultibandCompressor::process(int num_samples) {
     processWithInput(input(kAudio)->source->buffer, num_samples);
   }
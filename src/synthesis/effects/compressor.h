@@ -51,6 +51,7 @@ namespace vital {
       void processRms(const poly_float* audio_in, int num_samples);
       void scaleOutput(const poly_float* audio_input, int num_samples);
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       force_inline poly_float getInputMeanSquared() { return input_mean_squared_; }
       force_inline poly_float getOutputMeanSquared() { return output_mean_squared_; }
@@ -127,6 +128,7 @@ namespace vital {
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
       void setSampleRate(int sample_rate) override;
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
     protected:
       void packFilterOutput(LinkwitzRileyFilter* filter, int num_samples, poly_float* dest);
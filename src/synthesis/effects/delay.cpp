@@ -18,6 +18,7 @@
 
 #include "futils.h"
 #include "memory.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 namespace vital {
 
@@ -41,6 +42,16 @@ namespace vital {
     low_pass_.reset(constants::kFullMask);
     high_pass_.reset(constants::kFullMask);
   }
+
+  template<class MemoryType>
+  void Delay<MemoryType>::copyState(ProcessorSnapshot& snapshot) {
+    memory_->copyState(snapshot);
+    snapshot.copy(last_frequency_, feedback_, wet_, dry_, period_);
+    snapshot.copy(low_coefficient_, high_coefficient_, filter_gain_);
+    low_pass_.copyState(snapshot);
+    high_pass_.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
   
   template<class MemoryType>
   void Delay<MemoryType>::setMaxSamples(int max_samples) {
@@ -79,6 +79,7 @@ namespace vital {
       virtual Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
 
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void setMaxSamples(int max_samples);
 
       virtual void process(int num_samples) override;
@@ -16,6 +16,7 @@
 
 #include "distortion.h"
 
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 #include <climits>
@@ -177,4 +178,9 @@ namespace vital {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
     processWithInput(input(kAudio)->source->buffer, num_samples);
   }
+
+  void Distortion::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(last_distorted_value_, current_samples_, type_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
@@ -91,6 +91,7 @@ namespace vital {
 
       virtual void process(int num_samples) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
       template<poly_float(*distort)(poly_float, poly_float), poly_float(*scale)(poly_float)>
       void processTimeInvariant(int num_samples, const poly_float* audio_in, const poly_float* drive, 
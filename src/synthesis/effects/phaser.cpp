@@ -18,6 +18,7 @@
 
 #include "operators.h"
 #include "phaser_filter.h"
+#include "processor_snapshot.h"
 
 #include <climits>
 
@@ -44,6 +45,12 @@ namespace vital {
     phase_offset_ = input(kPhaseOffset)->at(0);
   }
 
+  void Phaser::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copyOutput(&cutoff_);
+    snapshot.copy(mix_, mod_depth_, phase_offset_, phase_);
+    ProcessorRouter::copyState(snapshot);
+  }
+
   void Phaser::process(int num_samples) {
     processWithInput(input(kAudio)->source->buffer, num_samples);
   }
@@ -52,6 +52,7 @@ namespace vital {
       void processWithInput(const poly_float* audio_in, int num_samples) override;
       void init() override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void correctToTime(double seconds);
       void setOversampleAmount(int oversample) override {
         ProcessorRouter::setOversampleAmount(oversample);
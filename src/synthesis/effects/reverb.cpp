@@ -18,6 +18,7 @@
 
 #include "futils.h"
 #include "memory.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 namespace vital {
@@ -147,14 +148,17 @@ namespace vital {
     const mono_float* allpass_lookup3 = (mono_float*)allpass_lookups_[2].get();
     const mono_float* allpass_lookup4 = (mono_float*)allpass_lookups_[3].get();
 
-    mono_float* feedback_lookups1[] = { feedback_lookups_[0], feedback_lookups_[1],
-                                        feedback_lookups_[2], feedback_lookups_[3] };
-    mono_float* feedback_lookups2[] = { feedback_lookups_[4], feedback_lookups_[5],
-                                        feedback_lookups_[6], feedback_lookups_[7] };
-    mono_float* feedback_lookups3[] = { feedback_lookups_[8], feedback_lookups_[9],
-                                        feedback_lookups_[10], feedback_lookups_[11] };
-    mono_float* feedback_lookups4[] = { feedback_lookups_[12], feedback_lookups_[13],
-                                        feedback_lookups_[14], feedback_lookups_[15] };
+    mono_float* feedback_lookups1[poly_float::kSize];
+    mono_float* feedback_lookups2[poly_float::kSize];
+    mono_float* feedback_lookups3[poly_float::kSize];
+    mono_float* feedback_lookups4[poly_float::kSize];
+    for (size_t i = 0; i < poly_float::kSize; ++i) {
+      int line = i % kContainerSize;
+      feedback_lookups1[i] = feedback_lookups_[line];
+      feedback_lookups2[i] = feedback_lookups_[kContainerSize + line];
+      feedback_lookups3[i] = feedback_lookups_[2 * kContainerSize + line];
+      feedback_lookups4[i] = feedback_lookups_[3 * kContainerSize + line];
+    }
 
     poly_float size = utils::clamp(input(kSize)->at(0), 0.0f, 1.0f);
     poly_float size_mult = futils::pow(2.0f, size * kSizePowerRange + kMinSizePower);
@@ -262,7 +266,7 @@ namespace vital {
       poly_float allpass_output4 = allpass_read4 + allpass_delay_input4 * kAllpassFeedback;
 
       poly_float total_rows = allpass_output1 + allpass_output2 + allpass_output3 + allpass_output4;
-      poly_float other_feedback = poly_float::mulAdd(total_rows.sum() * 0.25f, total_rows, -0.5f);
+      poly_float other_feedback = poly_float::mulAdd(total_rows.sum() * (1.0f / poly_float::kSize), total_rows, -0.5f);
 
       poly_float write1 = other_feedback + allpass_output1;
       poly_float write2 = other_feedback + allpass_output2;
@@ -323,7 +327,7 @@ namespace vital {
       write_index_ = (write_index_ + 1) & feedback_mask_;
 
       poly_float total_allpass = store1 + store2 + store3 + store4;
-      poly_float other_feedback_allpass = poly_float::mulAdd(total_allpass.sum() * 0.25f, total_allpass, -0.5f);
+      poly_float other_feedback_allpass = poly_float::mulAdd(total_allpass.sum() * (1.0f / poly_float::kSize), total_allpass, -0.5f);
 
       poly_float feed_forward1 = other_feedback_allpass + store1;
       poly_float feed_forward2 = other_feedback_allpass + store2;
@@ -391,4 +395,28 @@ namespace vital {
         feedback_memories_[n][i] = 0.0f;
     }
   }
+
+  void Reverb::copyState(ProcessorSnapshot& snapshot) {
+    memory_->copyState(snapshot);
+
+    snapshot.require(max_allpass_size_);
+    snapshot.require(max_feedback_size_);
+    for (int i = 0; i < kNetworkContainers; ++i)
+      snapshot.copyBuffer(allpass_lookups_[i].get(), max_allpass_size_);
+    for (int i = 0; i < kNetworkSize; ++i)
+      snapshot.copyBuffer(feedback_memories_[i].get(), max_feedback_size_ + kExtraLookupSample);
+
+    for (int i = 0; i < kNetworkContainers; ++i) {
+      low_shelf_filters_[i].copyState(snapshot);
+      high_shelf_filters_[i].copyState(snapshot);
+    }
+    low_pre_filter_.copyState(snapshot);
+    high_pre_filter_.copyState(snapshot);
+
+    snapshot.copy(decays_);
+    snapshot.copy(low_pre_coefficient_, high_pre_coefficient_, low_coefficient_, low_amplitude_);
+    snapshot.copy(high_coefficient_, high_amplitude_, chorus_phase_, chorus_amount_, feedback_, damping_);
+    snapshot.copy(sample_delay_, sample_delay_increment_, dry_, wet_, write_index_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
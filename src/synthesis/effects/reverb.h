@@ -35,7 +35,10 @@ namespace vital {
       static constexpr int kBaseFeedbackBits = 14;
       static constexpr int kExtraLookupSample = 4;
       static constexpr int kBaseAllpassBits = 10;
-      static constexpr int kNetworkContainers = kNetworkSize / poly_float::kSize;
+      // The network is sixteen delay lines in four containers of four. With
+      // wider values each half holds its own copy of a container.
+      static constexpr int kContainerSize = 4;
+      static constexpr int kNetworkContainers = kNetworkSize / kContainerSize;
       static constexpr int kMinSizePower = -3;
       static constexpr int kMaxSizePower = 1;
       static constexpr float kSizePowerRange = kMaxSizePower - kMinSizePower;
@@ -78,6 +81,7 @@ namespace vital {
       void setOversampleAmount(int oversample_amount) override;
       void setupBuffersForSampleRate(int sample_rate);
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       force_inline poly_float readFeedback(const mono_float* const* lookups, poly_float offset) {
         poly_float write_offset = poly_float(write_index_) - offset;
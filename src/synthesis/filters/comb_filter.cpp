@@ -18,6 +18,7 @@
 
 #include "futils.h"
 #include "memory.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -139,6 +140,15 @@ namespace vital {
     reset(constants::kFullMask);
   }
 
+  void CombFilter::copyState(ProcessorSnapshot& snapshot) {
+    memory_->copyState(snapshot);
+    snapshot.copy(feedback_style_, max_period_, feedback_, filter_coefficient_, filter2_coefficient_);
+    snapshot.copy(low_gain_, high_gain_, scale_, filter_midi_cutoff_, filter2_midi_cutoff_);
+    feedback_filter_.copyState(snapshot);
+    feedback_filter2_.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
+
   void CombFilter::setupFilter(const FilterState& filter_state) {
     feedback_style_ = getFeedbackStyle(filter_state.style);
     poly_float resonance = utils::clamp(filter_state.resonance_percent, 0.0f, 1.0f);
@@ -72,6 +72,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       poly_float getDrive() { return scale_; }
       poly_float getResonance() { return feedback_; }
@@ -16,6 +16,8 @@
 
 #include "dc_filter.h"
 
+#include "processor_snapshot.h"
+
 namespace vital {
 
   DcFilter::DcFilter() : Processor(DcFilter::kNumInputs, 1) {
@@ -53,4 +55,9 @@ namespace vital {
     past_in_ = utils::maskLoad(past_in_, 0.0f, reset_mask);
     past_out_ = utils::maskLoad(past_in_, 0.0f, reset_mask);
   }
+
+  void DcFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(past_in_, past_out_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
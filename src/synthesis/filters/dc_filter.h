@@ -43,6 +43,7 @@ namespace vital {
 
     private:
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       mono_float coefficient_;
 
@@ -17,6 +17,7 @@
 #include "decimator.h"
 
 #include "iir_halfband_decimator.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   Decimator::Decimator(int max_stages) : ProcessorRouter(kNumInputs, 1), max_stages_(max_stages) {
@@ -45,6 +46,11 @@ namespace vital {
       stages_[i]->reset(reset_mask);
   }
 
+  void Decimator::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(num_stages_);
+    ProcessorRouter::copyState(snapshot);
+  }
+
   void Decimator::process(int num_samples) {
     int num_stages = 0;
     if (input(kAudio)->source->owner) {
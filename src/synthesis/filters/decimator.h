@@ -35,6 +35,7 @@ namespace vital {
 
       void init() override;
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       virtual Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
 
@@ -17,6 +17,7 @@
 #include "digital_svf.h"
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   const DigitalSvf::SvfCoefficientLookup DigitalSvf::svf_coefficient_lookup_;
@@ -431,4 +432,11 @@ namespace vital {
     drive_ = 0.0f;
     post_multiply_ = 0.0f;
   }
+
+  void DigitalSvf::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(midi_cutoff_, resonance_, blends1_, blends2_, drive_, post_multiply_);
+    snapshot.copy(low_amount_, band_amount_, high_amount_);
+    snapshot.copy(ic1eq_pre_, ic2eq_pre_, ic1eq_, ic2eq_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
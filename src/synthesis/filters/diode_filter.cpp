@@ -17,6 +17,7 @@
 #include "diode_filter.h"
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   DiodeFilter::DiodeFilter() : Processor(DiodeFilter::kNumInputs, 1) {
@@ -39,6 +40,19 @@ namespace vital {
     post_multiply_ = 0.0f;
   }
 
+  void DiodeFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(resonance_, drive_, post_multiply_);
+    snapshot.copy(high_pass_ratio_, high_pass_amount_, feedback_high_pass_coefficient_);
+    high_pass_1_.copyState(snapshot);
+    high_pass_2_.copyState(snapshot);
+    high_pass_feedback_.copyState(snapshot);
+    stage1_.copyState(snapshot);
+    stage2_.copyState(snapshot);
+    stage3_.copyState(snapshot);
+    stage4_.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
+
   void DiodeFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
 
@@ -46,6 +46,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       poly_float getResonance() { return resonance_; }
       poly_float getDrive() { return drive_; }
@@ -17,6 +17,7 @@
 #include "dirty_filter.h"
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -46,6 +47,18 @@ namespace vital {
     high_pass_amount_ = 0.0f;
   }
 
+  void DirtyFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(coefficient_, resonance_, drive_, drive_boost_, drive_blend_, drive_mult_);
+    snapshot.copy(low_pass_amount_, band_pass_amount_, high_pass_amount_);
+    pre_stage1_.copyState(snapshot);
+    pre_stage2_.copyState(snapshot);
+    stage1_.copyState(snapshot);
+    stage2_.copyState(snapshot);
+    stage3_.copyState(snapshot);
+    stage4_.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
+
   void DirtyFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
 
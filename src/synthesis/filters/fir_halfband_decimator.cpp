@@ -16,6 +16,7 @@
 
 #include "fir_halfband_decimator.h"
 #include "poly_utils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   FirHalfbandDecimator::FirHalfbandDecimator() : Processor(kNumInputs, 1) {
@@ -117,4 +118,9 @@ namespace vital {
     for (int i = 0; i < kNumTaps / 2 - 1; ++i)
       memory_[i] = 0.0f;
   }
+
+  void FirHalfbandDecimator::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(memory_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
@@ -40,6 +40,7 @@ namespace vital {
 
     private:
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       poly_float memory_[kNumTaps / 2 - 1];
       poly_float taps_[kNumTaps / 2];
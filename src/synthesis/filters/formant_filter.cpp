@@ -19,6 +19,7 @@
 #include "digital_svf.h"
 #include "formant_manager.h"
 #include "operators.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 namespace vital {
@@ -214,4 +215,9 @@ namespace vital {
   void FormantFilter::hardReset() {
     getLocalProcessor(formant_manager_)->hardReset();
   }
+
+  void FormantFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(style_);
+    ProcessorRouter::copyState(snapshot);
+  }
 } // namespace vital
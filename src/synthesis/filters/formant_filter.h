@@ -40,6 +40,7 @@ namespace vital {
       
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void init() override;
 
       virtual Processor* clone() const override { return new FormantFilter(*this); }
@@ -16,6 +16,8 @@
 
 #include "iir_halfband_decimator.h"
 
+#include "processor_snapshot.h"
+
 namespace vital {
   poly_float IirHalfbandDecimator::kTaps9[kNumTaps9] = {
     { 0.167135116548925f, 0.0413554705262319f },
@@ -69,4 +71,9 @@ namespace vital {
       out_memory_[i] = 0.0f;
     }
   }
+
+  void IirHalfbandDecimator::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(in_memory_, out_memory_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
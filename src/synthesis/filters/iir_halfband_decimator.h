@@ -40,6 +40,7 @@ namespace vital {
 
       virtual void process(int num_samples) override;
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       force_inline void setSharpCutoff(bool sharp_cutoff) { sharp_cutoff_ = sharp_cutoff; }
 
     private:
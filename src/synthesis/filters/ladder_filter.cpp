@@ -17,6 +17,7 @@
 #include "ladder_filter.h"
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   LadderFilter::LadderFilter() : Processor(LadderFilter::kNumInputs, 1) {
@@ -37,6 +38,13 @@ namespace vital {
     post_multiply_ = 0.0f;
   }
 
+  void LadderFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(resonance_, drive_, post_multiply_, stage_scales_, filter_input_);
+    for (auto& stage : stages_)
+      stage.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
+
   void LadderFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
 
@@ -49,6 +49,7 @@ namespace vital {
     
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       poly_float getDrive() { return drive_; }
       poly_float getResonance() { return resonance_; }
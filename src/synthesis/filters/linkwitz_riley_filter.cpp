@@ -16,6 +16,8 @@
 
 #include "linkwitz_riley_filter.h"
 
+#include "processor_snapshot.h"
+
 namespace vital {
 
   LinkwitzRileyFilter::LinkwitzRileyFilter(mono_float cutoff) : Processor(kNumInputs, kNumOutputs) {
@@ -133,4 +135,10 @@ namespace vital {
       past_out_2b_[i] = utils::maskLoad(past_out_2b_[i], 0.0f, reset_mask);
     }
   }
+
+  void LinkwitzRileyFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(past_in_1a_, past_in_2a_, past_out_1a_, past_out_2a_);
+    snapshot.copy(past_in_1b_, past_in_2b_, past_out_1b_, past_out_2b_);
+    Processor::copyState(snapshot);
+  }
 } // namespace vital
@@ -45,6 +45,7 @@ namespace vital {
       void setSampleRate(int sample_rate) override;
       void setOversampleAmount(int oversample_amount) override;
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
     private:
       mono_float cutoff_;
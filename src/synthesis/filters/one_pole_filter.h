@@ -17,6 +17,7 @@
 #pragma once
 
 #include "common.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 #include "utils.h"
 
@@ -63,6 +64,10 @@ namespace vital {
         return current_state_;
       }
 
+      void copyState(ProcessorSnapshot& snapshot) {
+        snapshot.copy(current_state_, filter_state_, sat_filter_state_);
+      }
+
       force_inline poly_float getCurrentState() { return current_state_; }
       force_inline poly_float getNextSatState() { return sat_filter_state_; }
       force_inline poly_float getNextState() { return filter_state_; }
@@ -17,6 +17,7 @@
 #include "phaser_filter.h"
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
   PhaserFilter::PhaserFilter(bool clean) : Processor(PhaserFilter::kNumInputs, 1) {
@@ -44,6 +45,16 @@ namespace vital {
     allpass_output_ = 0.0f;
   }
 
+  void PhaserFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(resonance_, drive_, peak1_amount_, peak3_amount_, peak5_amount_, invert_mult_);
+    snapshot.copy(allpass_output_);
+    for (auto& stage : stages_)
+      stage.copyState(snapshot);
+    remove_lows_stage_.copyState(snapshot);
+    remove_highs_stage_.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
+
   void PhaserFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
     processWithInput(input(kAudio)->source->buffer, num_samples);
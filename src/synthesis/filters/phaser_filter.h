@@ -44,6 +44,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void setClean(bool clean) { clean_ = clean; }
 
       poly_float getResonance() { return resonance_; }
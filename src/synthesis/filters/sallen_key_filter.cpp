@@ -17,6 +17,7 @@
 #include "sallen_key_filter.h"
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -43,6 +44,16 @@ namespace vital {
     high_pass_amount_ = 0.0f;
   }
 
+  void SallenKeyFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(cutoff_, resonance_, drive_, post_multiply_);
+    snapshot.copy(low_pass_amount_, band_pass_amount_, high_pass_amount_, stage1_input_);
+    pre_stage1_.copyState(snapshot);
+    pre_stage2_.copyState(snapshot);
+    stage1_.copyState(snapshot);
+    stage2_.copyState(snapshot);
+    Processor::copyState(snapshot);
+  }
+
   void SallenKeyFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
     processWithInput(input(kAudio)->source->buffer, num_samples);
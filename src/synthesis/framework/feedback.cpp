@@ -30,6 +30,11 @@ namespace vital {
     }
   }
 
+  void Feedback::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(buffer_, buffer_index_);
+    Processor::copyState(snapshot);
+  }
+
   void Feedback::refreshOutput(int num_samples) {
     poly_float* audio_out = output(0)->buffer;
     int index = (kMaxBufferSize + buffer_index_ - num_samples) % kMaxBufferSize;
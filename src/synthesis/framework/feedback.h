@@ -17,6 +17,7 @@
 #pragma once
 
 #include "processor.h"
+#include "processor_snapshot.h"
 #include "utils.h"
 
 namespace vital {
@@ -32,6 +33,7 @@ namespace vital {
       virtual Processor* clone() const override { return new Feedback(*this); }
       virtual void process(int num_samples) override;
       virtual void refreshOutput(int num_samples);
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
       force_inline void tick(int i) {
         buffer_[i] = input(0)->source->buffer[i];
@@ -64,6 +66,11 @@ namespace vital {
           output()->buffer[0] = last_value_;
         }
 
+        void copyState(ProcessorSnapshot& snapshot) override {
+          snapshot.copy(last_value_);
+          ::vital::Feedback::copyState(snapshot);
+        }
+
       protected:
         poly_float last_value_;
     };
@@ -37,11 +37,19 @@ namespace vital {
       row3 = poly_float::mulAdd(row3, other.row3 - row3, t);
     }
 
+    // Before transposing, row i holds lane i of each half.
     force_inline void interpolateRows(const matrix& other, poly_float t) {
+#if VITAL_AVX2
+      row0 = poly_float::mulAdd(row0, other.row0 - row0, _mm256_permute_ps(t.value, _MM_SHUFFLE(0, 0, 0, 0)));
+      row1 = poly_float::mulAdd(row1, other.row1 - row1, _mm256_permute_ps(t.value, _MM_SHUFFLE(1, 1, 1, 1)));
+      row2 = poly_float::mulAdd(row2, other.row2 - row2, _mm256_permute_ps(t.value, _MM_SHUFFLE(2, 2, 2, 2)));
+      row3 = poly_float::mulAdd(row3, other.row3 - row3, _mm256_permute_ps(t.value, _MM_SHUFFLE(3, 3, 3, 3)));
+#else
       row0 = poly_float::mulAdd(row0, other.row0 - row0, t[0]);
       row1 = poly_float::mulAdd(row1, other.row1 - row1, t[1]);
       row2 = poly_float::mulAdd(row2, other.row2 - row2, t[2]);
       row3 = poly_float::mulAdd(row3, other.row3 - row3, t[3]);
+#endif
     }
 
     force_inline poly_float sumRows() {
@@ -110,6 +110,11 @@ namespace vital {
     processMultiply(num_samples, input(kControlRate)->at(0));
   }
 
+  void SmoothMultiply::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(multiply_);
+    Operator::copyState(snapshot);
+  }
+
   void SmoothMultiply::processMultiply(int num_samples, poly_float multiply) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudioRate));
 
@@ -161,6 +166,11 @@ namespace vital {
     }
   }
 
+  void Interpolate::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(fraction_);
+    Operator::copyState(snapshot);
+  }
+
   void BilinearInterpolate::process(int num_samples) {
     static constexpr float kMaxOffset = 1.0f;
 
@@ -250,6 +260,11 @@ namespace vital {
     output()->trigger_value = dest[0];
   }
 
+  void ModulationSum::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(control_value_);
+    Operator::copyState(snapshot);
+  }
+
   void SampleAndHoldBuffer::process(int num_samples) {
     poly_float value = input()->source->buffer[0];
     poly_float* dest = output()->buffer;
@@ -267,6 +282,11 @@ namespace vital {
       processCenter(num_samples);
   }
 
+  void StereoEncoder::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(cos_mult_, sin_mult_);
+    Operator::copyState(snapshot);
+  }
+
   void StereoEncoder::processRotate(int num_samples) {
     static const poly_float kSign(1.0f, -1.0f);
     VITAL_ASSERT(inputMatchesBufferSize());
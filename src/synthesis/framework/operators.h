@@ -18,6 +18,7 @@
 
 #include "futils.h"
 #include "processor.h"
+#include "processor_snapshot.h"
 #include "utils.h"
 
 namespace vital {
@@ -54,6 +55,11 @@ namespace vital {
         setEnabled();
       }
 
+      void copyState(ProcessorSnapshot& snapshot) override {
+        snapshot.copy(externally_enabled_);
+        Processor::copyState(snapshot);
+      }
+
       virtual bool hasState() const override { return false; }
 
     private:
@@ -170,6 +176,7 @@ namespace vital {
       }
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       virtual bool hasState() const override { return true; }
 
@@ -223,6 +230,7 @@ namespace vital {
       bool hasState() const override { return true; }
 
       virtual void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
     protected:
       void processMultiply(int num_samples, poly_float multiply);
@@ -269,6 +277,7 @@ namespace vital {
       }
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
     private:
       poly_float fraction_;
@@ -344,6 +353,7 @@ namespace vital {
       void process(int num_samples) override;
       void processRotate(int num_samples);
       void processCenter(int num_samples);
+      void copyState(ProcessorSnapshot& snapshot) override;
 
       bool hasState() const override { return true; }
 
@@ -161,18 +161,30 @@ namespace vital {
     #endif
     }
 
+    force_inline poly_float toPolyFloatFromUnaligned(const mono_float* low, [[maybe_unused]] const mono_float* high) {
+    #if VITAL_AVX2
+      return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+    #else
+      return toPolyFloatFromUnaligned(low);
+    #endif
+    }
+
+    // Row i holds the four values from lane i's index on, in each half, so
+    // transposing puts one interpolation tap per row.
     force_inline matrix getValueMatrix(const mono_float* buffer, poly_int indices) {
-      return matrix(toPolyFloatFromUnaligned(buffer + indices[0]),
-                    toPolyFloatFromUnaligned(buffer + indices[1]),
-                    toPolyFloatFromUnaligned(buffer + indices[2]),
-                    toPolyFloatFromUnaligned(buffer + indices[3]));
+      static constexpr int kHalf = poly_float::kSize > 4 ? 4 : 0;
+      return matrix(toPolyFloatFromUnaligned(buffer + indices[0], buffer + indices[kHalf]),
+                    toPolyFloatFromUnaligned(buffer + indices[1], buffer + indices[kHalf + 1]),
+                    toPolyFloatFromUnaligned(buffer + indices[2], buffer + indices[kHalf + 2]),
+                    toPolyFloatFromUnaligned(buffer + indices[3], buffer + indices[kHalf + 3]));
     }
 
     force_inline matrix getValueMatrix(const mono_float* const* buffers, poly_int indices) {
-      return matrix(toPolyFloatFromUnaligned(buffers[0] + indices[0]),
-                    toPolyFloatFromUnaligned(buffers[1] + indices[1]),
-                    toPolyFloatFromUnaligned(buffers[2] + indices[2]),
-                    toPolyFloatFromUnaligned(buffers[3] + indices[3]));
+      static constexpr int kHalf = poly_float::kSize > 4 ? 4 : 0;
+      return matrix(toPolyFloatFromUnaligned(buffers[0] + indices[0], buffers[kHalf] + indices[kHalf]),
+                    toPolyFloatFromUnaligned(buffers[1] + indices[1], buffers[kHalf + 1] + indices[kHalf + 1]),
+                    toPolyFloatFromUnaligned(buffers[2] + indices[2], buffers[kHalf + 2] + indices[kHalf + 2]),
+                    toPolyFloatFromUnaligned(buffers[3] + indices[3], buffers[kHalf + 3] + indices[kHalf + 3]));
     }
 
     force_inline poly_float interpolate(poly_float from, poly_float to, poly_float t) {
@@ -287,7 +299,7 @@ namespace vital {
 
     force_inline poly_int swapVoices(poly_int value) {
     #if VITAL_AVX2
-      return _mm256_shuffle_epi32(value.value, value.value, _MM_SHUFFLE(1, 0, 3, 2));
+      return _mm256_shuffle_epi32(value.value, _MM_SHUFFLE(1, 0, 3, 2));
     #elif VITAL_SSE2
       return _mm_shuffle_epi32(value.value, _MM_SHUFFLE(1, 0, 3, 2));
     #elif VITAL_NEON
@@ -295,6 +307,45 @@ namespace vital {
     #endif
     }
 
+    force_inline poly_float swapHalves(poly_float value) {
+    #if VITAL_AVX2
+      return _mm256_permute2f128_ps(value.value, value.value, 1);
+    #else
+      return value;
+    #endif
+    }
+
+    force_inline poly_int swapHalves(poly_int value) {
+    #if VITAL_AVX2
+      return _mm256_permute2x128_si256(value.value, value.value, 1);
+    #else
+      return value;
+    #endif
+    }
+
+    // Every voice gets the total of all voices, per channel. Without AVX2
+    // there is only one pair of voices.
+    force_inline poly_float sumVoices(poly_float value) {
+      poly_float pairs = value + swapVoices(value);
+    #if VITAL_AVX2
+      return pairs + swapHalves(pairs);
+    #else
+      return pairs;
+    #endif
+    }
+
+    force_inline poly_float copyFirstVoice(poly_float value) {
+    #if VITAL_AVX2
+      __m256 low = _mm256_permute2f128_ps(value.value, value.value, 0);
+      return _mm256_shuffle_ps(low, low, _MM_SHUFFLE(1, 0, 1, 0));
+    #elif VITAL_SSE2
+      return _mm_shuffle_ps(value.value, value.value, _MM_SHUFFLE(1, 0, 1, 0));
+    #elif VITAL_NEON
+      float32x2_t low = vget_low_f32(value.value);
+      return vcombine_f32(low, low);
+    #endif
+    }
+
     force_inline poly_float swapInner(poly_float value) {
     #if VITAL_AVX2
       return _mm256_shuffle_ps(value.value, value.value, _MM_SHUFFLE(3, 1, 2, 0));
@@ -345,12 +396,14 @@ namespace vital {
     force_inline mono_float maxFloat(poly_float values) {
       poly_float swap_voices = swapVoices(values);
       poly_float max_voice = utils::max(values, swap_voices);
+      max_voice = utils::max(max_voice, swapHalves(max_voice));
       return utils::max(max_voice, utils::swapStereo(max_voice))[0];
     }
 
     force_inline mono_float minFloat(poly_float values) {
       poly_float swap_voices = swapVoices(values);
       poly_float min_voice = utils::min(values, swap_voices);
+      min_voice = utils::min(min_voice, swapHalves(min_voice));
       return utils::min(min_voice, utils::swapStereo(min_voice))[0];
     }
 
@@ -565,7 +618,7 @@ namespace vital {
     template<size_t shift>
     force_inline poly_int shiftRight(poly_int integer) {
     #if VITAL_AVX2
-      return _mm256_srli_epi32(integers.value, shift);
+      return _mm256_srli_epi32(integer.value, shift);
     #elif VITAL_SSE2
       return _mm_srli_epi32(integer.value, shift);
     #elif VITAL_NEON
@@ -576,7 +629,7 @@ namespace vital {
     template<size_t shift>
     force_inline poly_int shiftLeft(poly_int integer) {
     #if VITAL_AVX2
-      return _mm256_slli_epi32(integers.value, shift);
+      return _mm256_slli_epi32(integer.value, shift);
     #elif VITAL_SSE2
       return _mm_slli_epi32(integer.value, shift);
     #elif VITAL_NEON
@@ -20,9 +20,13 @@
 #include <climits>
 #include <cstdlib>
 
+// An AVX2 value is two four lane halves side by side. Shuffles and the four
+// value constructors work on each half the same way they do on a whole SSE2
+// or NEON value, so lanes only mix across halves in sums and masks.
 #if VITAL_AVX2
-  #define VITAL_AVX2 1
-  static_assert(false, "AVX2 is not supported yet.");
+  #if !defined(__AVX2__)
+    static_assert(false, "VITAL_AVX2 needs AVX2 code generation, e.g. -mavx2 -mfma or /arch:AVX2");
+  #endif
 #elif __SSE2__
   #define VITAL_SSE2 1
 #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
@@ -31,7 +35,7 @@
   static_assert(false, "No SIMD Intrinsics found which are necessary for compilation");
 #endif
 
-#if VITAL_SSE2
+#if VITAL_AVX2 || VITAL_SSE2
   #include <immintrin.h>
 #elif VITAL_NEON
   #include <arm_neon.h>
@@ -86,7 +90,7 @@ namespace vital {
 
     static force_inline simd_type vector_call load(const uint32_t* memory) {
 #if VITAL_AVX2
-      return _mm256_loadu_si256((const __m256i*)scalar);
+      return _mm256_loadu_si256((const __m256i*)memory);
 #elif VITAL_SSE2
       return _mm_loadu_si128((const __m128i*)memory);
 #elif VITAL_NEON
@@ -126,7 +130,7 @@ namespace vital {
 
     static force_inline simd_type vector_call mul(simd_type one, simd_type two) {
 #if VITAL_AVX2
-      return _mm256_mul_epi32(one, two);
+      return _mm256_mullo_epi32(one, two);
 #elif VITAL_SSE2
       simd_type mul0_2 = _mm_mul_epu32(one, two);
       simd_type mul1_3 = _mm_mul_epu32(_mm_shuffle_epi32(one, _MM_SHUFFLE(2, 3, 0, 1)),
@@ -174,7 +178,7 @@ namespace vital {
 
     static force_inline simd_type vector_call max(simd_type one, simd_type two) {
 #if VITAL_AVX2
-      return _mm256_max_epi32(one, two);
+      return _mm256_max_epu32(one, two);
 #elif VITAL_SSE2
       simd_type greater_than_mask = greaterThan(one, two);
       return _mm_or_si128(_mm_and_si128(greater_than_mask, one), _mm_andnot_si128(greater_than_mask, two));
@@ -216,10 +220,10 @@ namespace vital {
 
     static force_inline uint32_t vector_call sum(simd_type value) {
 #if VITAL_AVX2
-      simd_type flip = _mm256_permute4x64_epi64(value, _MM_SHUFFLE(1, 0, 3, 2))
-      simd_type sum = _mm256_hadd_epi32(value, flip);
-      sum = _mm256_hadd_epi32(sum, sum);
-      return _mm256_cvtsi256_si32(sum);
+      __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+      sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+      sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+      return _mm_cvtsi128_si32(sum);
 #elif VITAL_SSE2
       simd_scalar_union union_value { value };
       uint32_t total = 0;
@@ -278,8 +282,12 @@ namespace vital {
     }
 
     force_inline poly_int(uint32_t first, uint32_t second, uint32_t third, uint32_t fourth) noexcept {
+#if VITAL_AVX2
+      value = _mm256_setr_epi32(first, second, third, fourth, first, second, third, fourth);
+#else
       scalar_simd_union union_value { (int32_t)first, (int32_t)second, (int32_t)third, (int32_t)fourth };
       value = union_value.simd;
+#endif
     }
 
     force_inline poly_int(uint32_t first, uint32_t second) noexcept : poly_int(first, second, first, second) { }
@@ -287,10 +295,7 @@ namespace vital {
     force_inline ~poly_int() noexcept { }
 
     force_inline uint32_t vector_call access(size_t index) const noexcept {
-#if VITAL_AVX2
-      simd_union union_value { value };
-      return union_value.scalar[index];
-#elif VITAL_SSE2
+#if VITAL_AVX2 || VITAL_SSE2
       simd_scalar_union union_value { value };
       return union_value.scalar[index];
 #elif VITAL_NEON
@@ -299,11 +304,7 @@ namespace vital {
     }
 
     force_inline void vector_call set(size_t index, uint32_t new_value) noexcept {
-#if VITAL_AVX2
-      simd_union union_value { value };
-      union_value.scalar[index] = new_value;
-      value = union_value.simd;
-#elif VITAL_SSE2
+#if VITAL_AVX2 || VITAL_SSE2
       simd_scalar_union union_value { value };
       union_value.scalar[index] = new_value;
       value = union_value.simd;
@@ -481,7 +482,7 @@ namespace vital {
 
     static force_inline simd_type vector_call init(float scalar) {
 #if VITAL_AVX2
-      return _mm256_broadcast_ss(&scalar);
+      return _mm256_set1_ps(scalar);
 #elif VITAL_SSE2
       return _mm_set1_ps(scalar);
 #elif VITAL_NEON
@@ -491,7 +492,7 @@ namespace vital {
 
     static force_inline simd_type vector_call load(const float* memory) {
 #if VITAL_AVX2
-      return _mm256_loadu_ps(&scalar);
+      return _mm256_loadu_ps(memory);
 #elif VITAL_SSE2
       return _mm_loadu_ps(memory);
 #elif VITAL_NEON
@@ -541,7 +542,7 @@ namespace vital {
 
     static force_inline simd_type vector_call mulScalar(simd_type value, float scalar) {
 #if VITAL_AVX2
-      return _mm256_mul_ps(value, _mm_set1_ps(scalar));
+      return _mm256_mul_ps(value, _mm256_set1_ps(scalar));
 #elif VITAL_SSE2
       return _mm_mul_ps(value, _mm_set1_ps(scalar));
 #elif VITAL_NEON
@@ -550,8 +551,10 @@ namespace vital {
     }
 
     static force_inline simd_type vector_call mulAdd(simd_type one, simd_type two, simd_type three) {
-#if VITAL_AVX2
+#if VITAL_AVX2 && defined(__FMA__)
       return _mm256_fmadd_ps(two, three, one);
+#elif VITAL_AVX2
+      return _mm256_add_ps(one, _mm256_mul_ps(two, three));
 #elif VITAL_SSE2
       return _mm_add_ps(one, _mm_mul_ps(two, three));
 #elif VITAL_NEON
@@ -564,8 +567,10 @@ namespace vital {
     }
 
     static force_inline simd_type vector_call mulSub(simd_type one, simd_type two, simd_type three) {
-#if VITAL_AVX2
-      return _mm256_fsub_ps(two, three, one);
+#if VITAL_AVX2 && defined(__FMA__)
+      return _mm256_fnmadd_ps(two, three, one);
+#elif VITAL_AVX2
+      return _mm256_sub_ps(one, _mm256_mul_ps(two, three));
 #elif VITAL_SSE2
       return _mm_sub_ps(one, _mm_mul_ps(two, three));
 #elif VITAL_NEON
@@ -658,7 +663,7 @@ namespace vital {
 
     static force_inline mask_simd_type vector_call equal(simd_type one, simd_type two) {
 #if VITAL_AVX2
-      return toMask(_mm256_cmpeq_ps(one, two, _CMP_EQ_OQ));
+      return toMask(_mm256_cmp_ps(one, two, _CMP_EQ_OQ));
 #elif VITAL_SSE2
       return toMask(_mm_cmpeq_ps(one, two));
 #elif VITAL_NEON
@@ -688,7 +693,7 @@ namespace vital {
 
     static force_inline mask_simd_type vector_call notEqual(simd_type one, simd_type two) {
 #if VITAL_AVX2
-      return toMask(_mm256_cmp_ps(one, two, _CMP_NEQ_OQ));
+      return toMask(_mm256_cmp_ps(one, two, _CMP_NEQ_UQ));
 #elif VITAL_SSE2
       return toMask(_mm_cmpneq_ps(one, two));
 #elif VITAL_NEON
@@ -700,10 +705,11 @@ namespace vital {
 
     static force_inline float vector_call sum(simd_type value) {
 #if VITAL_AVX2
-      simd_type flip = _mm256_permute2f128_ps(value, value, 1)
-      simd_type sum = _mm256_hadd_ps(value, flip);
-      sum = _mm256_hadd_ps(sum, sum);
-      return _mm256_cvtss_f32(sum);
+      __m128 halves = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+      __m128 flip = _mm_shuffle_ps(halves, halves, _MM_SHUFFLE(1, 0, 3, 2));
+      __m128 sum = _mm_add_ps(halves, flip);
+      __m128 swap = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+      return _mm_cvtss_f32(_mm_add_ps(sum, swap));
 #elif VITAL_SSE2
       simd_type flip = _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2));
       simd_type sum = _mm_add_ps(value, flip);
@@ -719,7 +725,14 @@ namespace vital {
     static force_inline void vector_call transpose(simd_type& row0, simd_type& row1,
                                                    simd_type& row2, simd_type& row3) {
 #if VITAL_AVX2
-      static_assert(false, "AVX2 transpose not supported yet");
+      __m256 low0 = _mm256_unpacklo_ps(row0, row1);
+      __m256 low1 = _mm256_unpacklo_ps(row2, row3);
+      __m256 high0 = _mm256_unpackhi_ps(row0, row1);
+      __m256 high1 = _mm256_unpackhi_ps(row2, row3);
+      row0 = _mm256_shuffle_ps(low0, low1, _MM_SHUFFLE(1, 0, 1, 0));
+      row1 = _mm256_shuffle_ps(low0, low1, _MM_SHUFFLE(3, 2, 3, 2));
+      row2 = _mm256_shuffle_ps(high0, high1, _MM_SHUFFLE(1, 0, 1, 0));
+      row3 = _mm256_shuffle_ps(high0, high1, _MM_SHUFFLE(3, 2, 3, 2));
 #elif VITAL_SSE2
       __m128 low0 = _mm_unpacklo_ps(row0, row1);
       __m128 low1 = _mm_unpacklo_ps(row2, row3);
@@ -794,23 +807,22 @@ namespace vital {
     force_inline poly_float(simd_type initial_value) noexcept : value(initial_value) { }
     force_inline poly_float(float initial_value) noexcept { value = init(initial_value); }
 
-    force_inline poly_float(float initial_value1, float initial_value2) noexcept {
-      scalar_simd_union union_value { initial_value1, initial_value2, initial_value1, initial_value2 };
-      value = union_value.simd;
-    }
+    force_inline poly_float(float initial_value1, float initial_value2) noexcept :
+        poly_float(initial_value1, initial_value2, initial_value1, initial_value2) { }
 
     force_inline poly_float(float first, float second, float third, float fourth) noexcept {
+#if VITAL_AVX2
+      value = _mm256_setr_ps(first, second, third, fourth, first, second, third, fourth);
+#else
       scalar_simd_union union_value { first, second, third, fourth };
       value = union_value.simd;
+#endif
     }
 
     force_inline ~poly_float() noexcept { }
 
     force_inline float vector_call access(size_t index) const noexcept {
-#if VITAL_AVX2
-      simd_union union_value { value };
-      return union_value.scalar[index];
-#elif VITAL_SSE2
+#if VITAL_AVX2 || VITAL_SSE2
       simd_scalar_union union_value { value };
       return union_value.scalar[index];
 #elif VITAL_NEON
@@ -819,11 +831,7 @@ namespace vital {
     }
 
     force_inline void vector_call set(size_t index, float new_value) noexcept {
-#if VITAL_AVX2
-      simd_union union_value { value };
-      union_value.scalar[index] = new_value;
-      value = union_value.simd;
-#elif VITAL_SSE2
+#if VITAL_AVX2 || VITAL_SSE2
       simd_scalar_union union_value { value };
       union_value.scalar[index] = new_value;
       value = union_value.simd;
@@ -18,6 +18,7 @@
 
 #include "feedback.h"
 #include "processor_router.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -40,6 +41,16 @@ namespace vital {
       addOutput(max_oversample);
   }
 
+  void Processor::copyState(ProcessorSnapshot& snapshot) {
+    bool was_enabled = state_->enabled;
+    snapshot.copy(state_->enabled);
+    if (state_->enabled != was_enabled)
+      scheduleChanged();
+
+    for (auto& output : owned_outputs_)
+      snapshot.copyOutput(output.get());
+  }
+
   bool Processor::inputMatchesBufferSize(int input) {
     if (input >= inputs_->size())
       return false;
@@ -199,6 +210,12 @@ namespace vital {
     return top_level;
   }
 
+  void Processor::scheduleChanged() {
+    ProcessorRouter* top_level = getTopLevelRouter();
+    if (top_level)
+      top_level->invalidateSchedules();
+  }
+
   void Processor::registerInput(Input* input) {
     inputs_->push_back(input);
 
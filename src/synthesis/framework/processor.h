@@ -26,6 +26,7 @@ namespace vital {
 
   class Processor;
   class ProcessorRouter;
+  class ProcessorSnapshot;
 
   struct Output {
     Output(int size = kMaxBufferSize, int max_oversample = 1) {
@@ -153,6 +154,10 @@ namespace vital {
       // Override this to handle state resetting when the Processor is turned off/on.
       virtual void hardReset() { reset(poly_mask(-1)); }
 
+      // Override this to save and restore whatever process() carries from one
+      // block to the next. Overrides copy their members and call their parent.
+      virtual void copyState(ProcessorSnapshot& snapshot);
+
       bool initialized() { return state_->initialized; }
 
       // Subclasses should override this if they need to adjust for change in
@@ -162,6 +167,8 @@ namespace vital {
       }
 
       virtual void setOversampleAmount(int oversample) {
+        if (state_->oversample_amount != oversample)
+          scheduleChanged();
         state_->sample_rate /= state_->oversample_amount;
         state_->oversample_amount = oversample;
         state_->sample_rate *= state_->oversample_amount;
@@ -176,7 +183,11 @@ namespace vital {
         return state_->enabled;
       }
 
+      // This also runs on the audio thread, e.g. when a SmoothValue settles or
+      // an effect is switched, so only an actual change rebuilds schedules.
       virtual void enable(bool enable) {
+        if (state_->enabled != enable)
+          scheduleChanged();
         state_->enabled = enable;
       }
 
@@ -303,6 +314,10 @@ namespace vital {
       Output* addOutput(int oversample = 1);
       Input* addInput();
 
+      // Tells the top-level router that which processors run, or at what
+      // oversampling, has changed so the routers rebuild their schedules.
+      void scheduleChanged();
+
       std::shared_ptr<ProcessorState> state_;
 
       int plugging_start_;
@@ -17,6 +17,7 @@
 #include "processor_router.h"
 
 #include "feedback.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 #include <algorithm>
@@ -30,17 +31,22 @@ namespace vital {
       global_reorder_(new CircularQueue<Processor*>(kMaxModulationConnections)),
       local_order_(kMaxModulationConnections),
       global_feedback_order_(new std::vector<const Feedback*>()),
-      global_changes_(new int(0)), local_changes_(0),
+      global_changes_(new int(0)), local_changes_(0), schedule_changes_(0),
+      schedule_top_level_(nullptr), schedule_local_changes_(0), schedule_state_changes_(0),
       dependencies_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
       dependencies_visited_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
-      dependency_inputs_(new CircularQueue<const Processor*>(kMaxModulationConnections)) { }
+      dependency_inputs_(new CircularQueue<const Processor*>(kMaxModulationConnections)) {
+    schedule_.reserve(kMaxModulationConnections);
+  }
 
   ProcessorRouter::ProcessorRouter(const ProcessorRouter& original) :
       Processor(original), global_order_(original.global_order_), global_reorder_(original.global_reorder_),
       global_feedback_order_(original.global_feedback_order_),
       global_changes_(original.global_changes_),
-      local_changes_(original.local_changes_) {
+      local_changes_(original.local_changes_), schedule_changes_(0),
+      schedule_top_level_(nullptr), schedule_local_changes_(0), schedule_state_changes_(0) {
     local_order_.reserve(global_order_->capacity());
+    schedule_.reserve(global_order_->capacity());
     local_order_.assign(global_order_->size(), 0);
     local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
 
@@ -63,6 +69,8 @@ namespace vital {
 
   ProcessorRouter::~ProcessorRouter() { }
 
+  bool ProcessorRouter::schedules_enabled_ = true;
+
   void ProcessorRouter::process(int num_samples) {
     if (shouldUpdate())
       updateAllProcessors();
@@ -72,17 +80,30 @@ namespace vital {
     for (int i = 0; i < num_feedbacks; ++i)
       local_feedback_order_[i]->refreshOutput(num_samples);
 
-    // Run all the main processors.
+    // Run all the main processors. If one of them enables or disables another
+    // the rest of the block checks each processor's state as it goes, and the
+    // schedule is rebuilt next block.
     int normal_samples = std::max(1, num_samples / getOversampleAmount());
-    for (Processor* processor : local_order_) {
-      if (processor->enabled()) {
-        int processor_samples = normal_samples * processor->getOversampleAmount();
+    if (schedules_enabled_) {
+      updateSchedule();
+
+      const std::atomic<int>& state_changes = schedule_top_level_->schedule_changes_;
+      for (const ScheduledProcessor& scheduled : schedule_) {
+        Processor* processor = scheduled.processor;
+        int processor_samples = normal_samples * scheduled.oversample_amount;
 
         VITAL_ASSERT(processor->checkInputAndOutputSize(processor_samples));
         processor->process(processor_samples);
         VITAL_ASSERT(utils::isFinite(processor->output()->buffer, processor->isControlRate() ? 0 : processor_samples));
+
+        if (state_changes.load(std::memory_order_relaxed) != schedule_state_changes_) {
+          processOrder(scheduled.order_index + 1, normal_samples);
+          break;
+        }
       }
     }
+    else
+      processOrder(0, normal_samples);
 
     // Store the outputs into the Feedback objects for next time.
     for (int i = 0; i < num_feedbacks; ++i) {
@@ -129,11 +150,34 @@ namespace vital {
       local_feedback_order_[i]->setOversampleAmount(oversample);
   }
 
+  void ProcessorRouter::copyState(ProcessorSnapshot& snapshot) {
+    // A voice that hasn't played since the graph changed would pick the
+    // change up on its next block. Pick it up now so both walks agree.
+    if (shouldUpdate())
+      updateAllProcessors();
+
+    Processor::copyState(snapshot);
+
+    // getLocalProcessor can leave empty entries behind for processors that
+    // aren't ours.
+    for (auto& processor : processors_) {
+      if (processor.second.second)
+        snapshot.copyProcessor(processor.second.second.get());
+    }
+    for (auto& processor : idle_processors_)
+      snapshot.copyProcessor(processor.second.get());
+    for (auto& feedback : feedback_processors_) {
+      if (feedback.second.second)
+        snapshot.copyProcessor(feedback.second.second.get());
+    }
+  }
+
   void ProcessorRouter::addProcessor(Processor* processor) {
     VITAL_ASSERT(processor->router() == nullptr);
     global_order_->ensureSpace();
     global_reorder_->ensureCapacity(global_order_->capacity());
     local_order_.ensureSpace();
+    schedule_.reserve(local_order_.capacity());
     addProcessorRealTime(processor);
   }
 
@@ -320,9 +364,49 @@ namespace vital {
     local_changes_ = *global_changes_;
   }
 
+  void ProcessorRouter::updateSchedule() {
+    bool graph_changed = schedule_top_level_ == nullptr || schedule_local_changes_ != local_changes_;
+    if (graph_changed) {
+      schedule_top_level_ = getTopLevelRouter();
+      if (schedule_top_level_ == nullptr)
+        schedule_top_level_ = this;
+    }
+
+    int state_changes = schedule_top_level_->schedule_changes_.load(std::memory_order_relaxed);
+    if (!graph_changed && schedule_state_changes_ == state_changes)
+      return;
+
+    schedule_local_changes_ = local_changes_;
+    schedule_state_changes_ = state_changes;
+
+    schedule_.clear();
+    int num_processors = local_order_.size();
+    for (int i = 0; i < num_processors; ++i) {
+      Processor* processor = local_order_[i];
+      if (processor->enabled())
+        schedule_.push_back({ processor, processor->getOversampleAmount(), i });
+    }
+  }
+
+  void ProcessorRouter::processOrder(int start, int normal_samples) {
+    int num_processors = local_order_.size();
+    for (int i = start; i < num_processors; ++i) {
+      Processor* processor = local_order_[i];
+      if (processor->enabled()) {
+        int processor_samples = normal_samples * processor->getOversampleAmount();
+
+        VITAL_ASSERT(processor->checkInputAndOutputSize(processor_samples));
+        processor->process(processor_samples);
+        VITAL_ASSERT(utils::isFinite(processor->output()->buffer, processor->isControlRate() ? 0 : processor_samples));
+      }
+    }
+  }
+
   void ProcessorRouter::createAddedProcessors() {
-    if (global_order_->size() > local_order_.capacity())
+    if (global_order_->size() > local_order_.capacity()) {
       local_order_.reserve(global_order_->capacity());
+      schedule_.reserve(local_order_.capacity());
+    }
    
     local_order_.assign(global_order_->size(), nullptr);
     local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
@@ -408,8 +492,10 @@ namespace vital {
           dependencies_->push_back(dependency);
         }
 
+        // Walk the inputs the processor reads, not the ones it owns. After
+        // useInput() the owned input at an index is no longer the one read.
         for (int j = 0; j < dependency_inputs_->at(i)->numInputs(); ++j) {
-          const Input* input = dependency_inputs_->at(i)->ownedInput(j);
+          const Input* input = dependency_inputs_->at(i)->input(j);
           if (input->source && input->source->owner && !dependencies_visited_->contains(input->source->owner)) {
             dependency_inputs_->ensureSpace();
             dependency_inputs_->push_back(input->source->owner);
@@ -19,6 +19,7 @@
 #include "processor.h"
 #include "circular_queue.h"
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <vector>
@@ -42,6 +43,7 @@ namespace vital {
       virtual void init() override;
       virtual void setSampleRate(int sample_rate) override;
       virtual void setOversampleAmount(int oversample) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
       virtual void addProcessor(Processor* processor);
       virtual void addProcessorRealTime(Processor* processor);
@@ -61,7 +63,24 @@ namespace vital {
       virtual ProcessorRouter* getPolyRouter();
       virtual void resetFeedbacks(poly_mask reset_mask);
 
+      // Called on the top-level router when any processor under it is enabled,
+      // disabled or changes oversampling.
+      force_inline void invalidateSchedules() { schedule_changes_.fetch_add(1, std::memory_order_relaxed); }
+      int scheduleChanges() const { return schedule_changes_.load(std::memory_order_relaxed); }
+
+      // With schedules off every router walks local_order_ and checks each
+      // processor's state every block. Lets benchmarks measure the schedules.
+      static void setSchedulesEnabled(bool enabled) { schedules_enabled_ = enabled; }
+
     protected:
+      // One enabled processor of local_order_, compiled so process can run
+      // them without checking each one's state every block.
+      struct ScheduledProcessor {
+        Processor* processor;
+        int oversample_amount;
+        int order_index;
+      };
+
       // When we create a cycle into the ProcessorRouter graph, we must insert
       // a Feedback node and add it here.
       virtual void addFeedback(Feedback* feedback);
@@ -76,6 +95,14 @@ namespace vital {
 
       force_inline bool shouldUpdate() { return local_changes_ != *global_changes_; }
 
+      // Rebuilds schedule_ from local_order_ if the graph or the state of
+      // any processor in it changed since it was last built. The top-level
+      // router is looked up again only when our own graph changed.
+      void updateSchedule();
+
+      // Runs local_order_ from _start_ on, checking each processor's state.
+      void processOrder(int start, int normal_samples);
+
       // Will create local copies of added processors. 
       virtual void createAddedProcessors();
 
@@ -103,6 +130,16 @@ namespace vital {
       std::shared_ptr<int> global_changes_;
       int local_changes_;
 
+      static bool schedules_enabled_;
+
+      // Only meaningful on the top-level router. See invalidateSchedules.
+      std::atomic<int> schedule_changes_;
+
+      std::vector<ScheduledProcessor> schedule_;
+      const ProcessorRouter* schedule_top_level_;
+      int schedule_local_changes_;
+      int schedule_state_changes_;
+
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_;
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_visited_;
       std::shared_ptr<CircularQueue<const Processor*>> dependency_inputs_;
@@ -0,0 +1,95 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "processor_snapshot.h"
+
+#include "processor.h"
+
+namespace vital {
+
+  void ProcessorSnapshot::save(Processor* processor) {
+    data_.clear();
+    source_ = processor;
+
+    start(kSaving);
+    copyProcessor(processor);
+  }
+
+  bool ProcessorSnapshot::restore(Processor* processor) {
+    if (data_.empty() || processor != source_)
+      return false;
+
+    start(kChecking);
+    copyProcessor(processor);
+    if (!matches_ || position_ != data_.size())
+      return false;
+
+    start(kRestoring);
+    copyProcessor(processor);
+    VITAL_ASSERT(matches_ && position_ == data_.size());
+    return true;
+  }
+
+  void ProcessorSnapshot::clear() {
+    data_.clear();
+    source_ = nullptr;
+  }
+
+  void ProcessorSnapshot::copyProcessor(Processor* processor) {
+    processor->copyState(*this);
+    require(position_);
+  }
+
+  void ProcessorSnapshot::copyOutput(Output* output) {
+    if (!copied_outputs_.insert(output).second)
+      return;
+
+    bool owns_buffer = output->buffer == output->owned_buffer.get();
+    require(owns_buffer);
+    if (owns_buffer) {
+      require(output->buffer_size);
+      copyBuffer(output->owned_buffer.get(), output->buffer_size);
+    }
+    copy(output->trigger_mask, output->trigger_value, output->trigger_offset);
+  }
+
+  void ProcessorSnapshot::start(Mode mode) {
+    mode_ = mode;
+    position_ = 0;
+    matches_ = true;
+    copied_outputs_.clear();
+  }
+
+  void ProcessorSnapshot::copyBytes(void* data, size_t size, bool live) {
+    if (mode_ == kSaving) {
+      const char* bytes = static_cast<const char*>(data);
+      data_.insert(data_.end(), bytes, bytes + size);
+      position_ = data_.size();
+      return;
+    }
+
+    if (position_ + size > data_.size()) {
+      VITAL_ASSERT(mode_ == kChecking);
+      matches_ = false;
+      position_ = data_.size();
+      return;
+    }
+
+    if (data && (mode_ == kRestoring || !live))
+      memcpy(data, data_.data() + position_, size);
+    position_ += size;
+  }
+} // namespace vital
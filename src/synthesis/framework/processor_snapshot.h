@@ -0,0 +1,145 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+#include "circular_queue.h"
+
+#include <cstring>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace vital {
+
+  struct Output;
+  class Processor;
+
+  // poly_float declares a destructor, which rules out std::is_trivially_copyable,
+  // so state is checked for being assignable byte for byte instead.
+  template<typename T>
+  constexpr bool isSnapshotCopyable() {
+    return std::is_trivially_copy_assignable<std::remove_all_extents_t<T>>::value;
+  }
+
+  // The state a processor graph carries from one block to the next: filter
+  // and delay memory, modulator phases, held voices and the buffers between
+  // processors. Every stateful Processor copies its members in copyState, and
+  // saving and restoring run that same walk, so both see members in one order.
+  class ProcessorSnapshot {
+    public:
+      enum Mode {
+        kSaving,
+        kChecking,
+        kRestoring
+      };
+
+      ProcessorSnapshot() : source_(nullptr), mode_(kSaving), position_(0), matches_(true) { }
+
+      // Replaces the snapshot with the state of processor and everything under it.
+      void save(Processor* processor);
+
+      // Puts the saved state back. Returns false without changing anything if
+      // processor isn't the one saved or its graph has changed since.
+      bool restore(Processor* processor);
+
+      void clear();
+      bool empty() const { return data_.empty(); }
+      size_t size() const { return data_.size(); }
+      Mode mode() const { return mode_; }
+
+      // Copies the state of a processor and records where it ends, so a
+      // restore onto a different graph fails the check instead of misreading.
+      void copyProcessor(Processor* processor);
+
+      // Copies the trigger and, if the output writes to its own buffer, the
+      // buffer. Outputs pointing at another output's buffer leave that to its
+      // owner. Outputs shared by voice clones are only copied once.
+      void copyOutput(Output* output);
+
+      template<typename T>
+      void copy(T& value) {
+        copyBuffer(&value, 1);
+      }
+
+      template<typename T, typename... Rest>
+      void copy(T& value, Rest&... rest) {
+        copy(value);
+        copy(rest...);
+      }
+
+      template<typename T>
+      void copyBuffer(T* values, size_t num) {
+        static_assert(isSnapshotCopyable<T>(), "Snapshots copy state byte for byte.");
+        copyBytes(values, num * sizeof(T), true);
+      }
+
+      // Saves value, or returns the saved value when checking or restoring.
+      // For sizes and flags that decide what gets copied after them.
+      template<typename T>
+      T copyValue(T value) {
+        static_assert(isSnapshotCopyable<T>(), "Snapshots copy state byte for byte.");
+        copyBytes(&value, sizeof(T), false);
+        return value;
+      }
+
+      // Fails the restore if value differs from what it was when saved, e.g.
+      // the wavetable that saved pointers point into.
+      template<typename T>
+      void require(T value) {
+        if (copyValue(value) != value)
+          matches_ = false;
+      }
+
+      template<typename T>
+      void copyQueue(CircularQueue<T>& queue) {
+        int size = copyValue(queue.size());
+        if (mode_ == kSaving) {
+          for (T& entry : queue)
+            copy(entry);
+        }
+        else if (mode_ == kChecking)
+          copyBytes(nullptr, size * sizeof(T), false);
+        else {
+          queue.clear();
+          queue.ensureCapacity(size);
+          for (int i = 0; i < size; ++i) {
+            T entry {};
+            copy(entry);
+            queue.push_back(entry);
+          }
+        }
+      }
+
+    private:
+      void start(Mode mode);
+
+      // Saving appends data. Checking only reads into data that isn't live
+      // processor state. Restoring reads into data.
+      void copyBytes(void* data, size_t size, bool live);
+
+      const Processor* source_;
+      Mode mode_;
+      size_t position_;
+      bool matches_;
+      std::vector<char> data_;
+      std::unordered_set<const Output*> copied_outputs_;
+
+      JUCE_LEAK_DETECTOR(ProcessorSnapshot)
+  };
+} // namespace vital
+
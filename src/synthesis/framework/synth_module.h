@@ -35,8 +35,7 @@ namespace vital {
       force_inline poly_float value() const { return value_; }
 
       force_inline void update(poly_mask voice_mask) {
-        poly_float masked_value = source_->buffer[0] & voice_mask;
-        value_ = masked_value + utils::swapVoices(masked_value);
+        value_ = utils::sumVoices(source_->buffer[0] & voice_mask);
       }
 
       force_inline void update() {
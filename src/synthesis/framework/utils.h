@@ -94,6 +94,9 @@ namespace vital {
           engine_.seed(new_seed);
         }
 
+        // The engine is all a generator changes as it runs. Snapshots copy it.
+        force_inline std::mt19937& engine() { return engine_; }
+
       private:
         std::mt19937 engine_;
         std::uniform_real_distribution<mono_float> distribution_;
@@ -16,6 +16,7 @@
 
 #include "value.h"
 
+#include "processor_snapshot.h"
 #include "utils.h"
 
 namespace vital {
@@ -49,6 +50,11 @@ namespace vital {
       output()->buffer[i] = value_;
   }
 
+  void Value::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(value_);
+    Processor::copyState(snapshot);
+  }
+
   void cr::Value::process(int num_samples) {
     poly_mask trigger_mask = input(kSet)->source->trigger_mask;
     if (trigger_mask.anyMask()) {
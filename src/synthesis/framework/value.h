@@ -32,6 +32,7 @@ namespace vital {
       virtual Processor* clone() const override { return new Value(*this); }
       virtual void process(int num_samples) override;
       virtual void setOversampleAmount(int oversample) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
       force_inline mono_float value() const { return value_[0]; }
       virtual void set(poly_float value);
@@ -16,6 +16,7 @@
 
 #include "voice_handler.h"
 
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 #include "utils.h"
 
@@ -74,6 +75,11 @@ namespace vital {
     last_key_state_ = kDead;
   }
 
+  void Voice::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(event_sample_, state_, last_key_state_, key_state_);
+    snapshot.copy(aftertouch_sample_, aftertouch_, slide_sample_, slide_);
+  }
+
   VoiceHandler::VoiceHandler(int num_outputs, int polyphony, bool control_rate) :
       SynthModule(kNumInputs, num_outputs, control_rate), polyphony_(0), legato_(false),
       voice_killer_(nullptr), last_num_voices_(0), last_played_note_(-1.0f),
@@ -223,7 +229,7 @@ namespace vital {
   }
 
   void VoiceHandler::clearAccumulatedOutputs() {
-    for (auto& output : accumulated_outputs_)
+    for (auto& output : active_accumulated_outputs_)
       utils::zeroBuffer(output.second->buffer, output.second->buffer_size);
   }
 
@@ -233,7 +239,7 @@ namespace vital {
   }
 
   void VoiceHandler::accumulateOutputs(int num_samples) {
-    for (auto& output : accumulated_outputs_) {
+    for (auto& output : active_accumulated_outputs_) {
       int buffer_size = std::min(num_samples, output.second->buffer_size);
       poly_float* dest = output.second->buffer;
       const poly_float* source = output.first->buffer;
@@ -244,12 +250,12 @@ namespace vital {
   }
 
   void VoiceHandler::combineAccumulatedOutputs(int num_samples) {
-    for (auto& output : accumulated_outputs_) {
+    for (auto& output : active_accumulated_outputs_) {
       int buffer_size = std::min(num_samples, output.second->buffer_size);
       poly_float* dest = output.second->buffer;
 
       for (int i = 0; i < buffer_size; ++i)
-        dest[i] += utils::swapVoices(dest[i]);
+        dest[i] = utils::sumVoices(dest[i]);
     }
   }
 
@@ -261,10 +267,8 @@ namespace vital {
 
       VITAL_ASSERT(buffer_size == 1);
 
-      for (int i = 0; i < buffer_size; ++i) {
-        poly_float masked = source[i] & voice_mask;
-        dest[i] = masked + utils::swapVoices(masked);
-      }
+      for (int i = 0; i < buffer_size; ++i)
+        dest[i] = utils::sumVoices(source[i] & voice_mask);
     }
   }
 
@@ -297,12 +301,12 @@ namespace vital {
 
     active_aggregate_voices_.clear();
     AggregateVoice* last_aggregate_voice = nullptr;
-    int last_aggregate_index = 0;
+    poly_mask last_voice_mask = constants::kFirstMask;
     for (Voice* active_voice : active_voices_) {
       if (active_aggregate_voices_.count(active_voice->parent()) == 0)
         active_aggregate_voices_.push_back(active_voice->parent());
       last_aggregate_voice = active_voice->parent();
-      last_aggregate_index = active_voice->voice_index();
+      last_voice_mask = active_voice->voice_mask();
     }
 
     if (last_aggregate_voice) {
@@ -335,19 +339,47 @@ namespace vital {
     combineAccumulatedOutputs(num_samples);
 
     if (active_voices_.size()) {
-      poly_mask voice_mask = constants::kFirstMask;
-      if (last_aggregate_index)
-        voice_mask = ~voice_mask;
-
-      writeNonaccumulatedOutputs(voice_mask, num_samples);
-
-      last_played_note_ = voice_midi_->trigger_value & voice_mask;
-      last_played_note_ += utils::swapVoices(last_played_note_);
+      writeNonaccumulatedOutputs(last_voice_mask, num_samples);
+      last_played_note_ = utils::sumVoices(voice_midi_->trigger_value & last_voice_mask);
     }
 
     last_num_voices_ = num_voices;
   }
 
+  void VoiceHandler::copyState(ProcessorSnapshot& snapshot) {
+    SynthModule::copyState(snapshot);
+
+    // The voice queues hold pointers into all_voices_.
+    snapshot.require(all_voices_.size());
+    snapshot.copy(polyphony_, legato_, last_num_voices_, last_played_note_);
+    snapshot.copy(voice_priority_, voice_override_, total_notes_);
+    snapshot.copy(sustain_, sostenuto_, mod_wheel_values_, pitch_wheel_values_, zoned_pitch_wheel_values_);
+    snapshot.copy(pressure_values_, slide_values_);
+    snapshot.copyQueue(pressed_notes_);
+    snapshot.copyQueue(free_voices_);
+    snapshot.copyQueue(active_voices_);
+    snapshot.copyQueue(active_aggregate_voices_);
+
+    Output* voice_outputs[] = {
+      &voice_event_, &retrigger_, &reset_, &note_, &last_note_, &note_pressed_, &note_count_, &note_in_octave_,
+      &channel_, &velocity_, &lift_, &aftertouch_, &slide_, &active_mask_, &mod_wheel_, &pitch_wheel_,
+      &pitch_wheel_percent_, &local_pitch_bend_
+    };
+    for (Output* output : voice_outputs)
+      snapshot.copyOutput(output);
+    for (auto& output : last_voice_outputs_)
+      snapshot.copyOutput(output.second.get());
+    for (auto& output : accumulated_outputs_)
+      snapshot.copyOutput(output.second.get());
+
+    for (auto& voice : all_voices_)
+      voice->copyState(snapshot);
+    for (auto& aggregate_voice : all_aggregate_voices_)
+      snapshot.copyProcessor(aggregate_voice->processor.get());
+    snapshot.copyProcessor(&voice_router_);
+    snapshot.copyProcessor(&global_router_);
+  }
+
   void VoiceHandler::init() {
     voice_router_.init();
     global_router_.init();
@@ -467,6 +499,16 @@ namespace vital {
 
     active_voices_.clear();
   }
+
+  void VoiceHandler::resetVoiceAllocation() {
+    VITAL_ASSERT(active_voices_.size() == 0);
+
+    free_voices_.clear();
+    for (auto& voice : all_voices_)
+      free_voices_.push_back(voice.get());
+    last_played_note_ = -1.0f;
+    total_notes_ = 0;
+  }
   
   void VoiceHandler::allNotesOff(int sample) {
     pressed_notes_.clear();
@@ -495,11 +537,8 @@ namespace vital {
   }
 
   poly_mask VoiceHandler::getCurrentVoiceMask() {
-    if (active_voices_.size()) {
-      if (active_voices_.back()->voice_index())
-        return ~constants::kFirstMask;
-      return constants::kFirstMask;
-    }
+    if (active_voices_.size())
+      return active_voices_.back()->voice_mask();
 
     return 0;
   }
@@ -819,8 +858,11 @@ namespace vital {
     new_output->owner = this;
     ProcessorRouter::registerOutput(new_output);
 
-    if (shouldAccumulate(output))
+    if (shouldAccumulate(output)) {
       accumulated_outputs_[output] = std::unique_ptr<Output>(new_output);
+      active_accumulated_outputs_.ensureCapacity(static_cast<int>(accumulated_outputs_.size()));
+      active_accumulated_outputs_.push_back({ output, new_output });
+    }
     else {
       last_voice_outputs_[output] = std::unique_ptr<Output>(new_output);
       nonaccumulated_outputs_.ensureCapacity(static_cast<int>(last_voice_outputs_.size()));
@@ -871,6 +913,24 @@ namespace vital {
     nonaccumulated_outputs_.remove(pair);
   }
 
+  void VoiceHandler::setActiveAccumulatedOutput(Output* output) {
+    if (accumulated_outputs_.count(output) == 0)
+      return;
+
+    std::pair<Output*, Output*> pair(output, accumulated_outputs_[output].get());
+    if (!active_accumulated_outputs_.contains(pair))
+      active_accumulated_outputs_.push_back(pair);
+  }
+
+  void VoiceHandler::setInactiveAccumulatedOutput(Output* output) {
+    if (accumulated_outputs_.count(output) == 0)
+      return;
+
+    std::pair<Output*, Output*> pair(output, accumulated_outputs_[output].get());
+    utils::zeroBuffer(pair.second->buffer, pair.second->buffer_size);
+    active_accumulated_outputs_.remove(pair);
+  }
+
   void VoiceHandler::addParallelVoices() {
     poly_float voice_value = 0.0f;
     for (int i = 0; i < kParallelVoices; ++i) {
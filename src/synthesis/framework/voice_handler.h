@@ -221,6 +221,8 @@ namespace vital {
         voice_mask_ = voice_mask;
       }
 
+      void copyState(ProcessorSnapshot& snapshot);
+
     private:
       int voice_index_;
       poly_mask voice_mask_;
@@ -283,6 +285,7 @@ namespace vital {
       virtual void process(int num_samples) override;
       virtual void init() override;
       virtual void setSampleRate(int sample_rate) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
       void setTuning(const Tuning* tuning) { tuning_ = tuning; }
 
       int getNumActiveVoices();
@@ -295,6 +298,10 @@ namespace vital {
       void allNotesOff(int sample, int channel) override;
       void allNotesOffRange(int sample, int from_channel, int to_channel);
 
+      // Hands voices out in creation order again and forgets the last note.
+      // Only call after allSoundsOff().
+      void resetVoiceAllocation();
+
       virtual void noteOn(int note, mono_float velocity, int sample, int channel) override;
       virtual void noteOff(int note, mono_float velocity, int sample, int channel) override;
 
@@ -410,6 +417,10 @@ namespace vital {
 
       void setActiveNonaccumulatedOutput(Output* output);
       void setInactiveNonaccumulatedOutput(Output* output);
+      // An inactive accumulated output isn't summed over the voices and holds
+      // zeros. Registered outputs start active.
+      void setActiveAccumulatedOutput(Output* output);
+      void setInactiveAccumulatedOutput(Output* output);
 
     protected:
       virtual bool shouldAccumulate(Output* output);
@@ -437,6 +448,7 @@ namespace vital {
       std::map<Output*, std::unique_ptr<Output>> last_voice_outputs_;
       CircularQueue<std::pair<Output*, Output*>> nonaccumulated_outputs_;
       std::map<Output*, std::unique_ptr<Output>> accumulated_outputs_;
+      CircularQueue<std::pair<Output*, Output*>> active_accumulated_outputs_;
       const Output* voice_killer_;
       const Output* voice_midi_;
       int last_num_voices_;
@@ -22,6 +22,7 @@
 #include <cmath>
 
 #include "poly_utils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -41,7 +42,7 @@ namespace vital {
       }
 
       MemoryTemplate(const MemoryTemplate& other) {
-        for (int i = 0; i < poly_float::kSize; ++i) {
+        for (int i = 0; i < kChannels; ++i) {
           memories_[i] = std::make_unique<mono_float[]>(2 * other.size_);
           buffers_[i] = memories_[i].get();
         }
@@ -106,9 +107,18 @@ namespace vital {
         return size_ - kExtraInterpolationValues;
       }
 
+      // Reads wrap around before going more than kExtraInterpolationValues into
+      // the second half of a buffer, so the rest of it never needs keeping.
+      void copyState(ProcessorSnapshot& snapshot) {
+        snapshot.require(size_);
+        snapshot.copy(offset_);
+        for (size_t c = 0; c < kChannels; ++c)
+          snapshot.copyBuffer(buffers_[c], size_ + kExtraInterpolationValues);
+      }
+
     protected:
-      std::unique_ptr<mono_float[]> memories_[poly_float::kSize];
-      mono_float* buffers_[poly_float::kSize];
+      std::unique_ptr<mono_float[]> memories_[kChannels];
+      mono_float* buffers_[kChannels];
       unsigned int size_;
       unsigned int bitmask_;
       unsigned int offset_;
@@ -146,8 +156,10 @@ namespace vital {
         matrix interpolation_matrix = utils::getCatmullInterpolationMatrix(t);
 
         poly_int indices = (poly_int(offset_) - past_index - 2) & poly_int(bitmask_);
-        matrix value_matrix(utils::toPolyFloatFromUnaligned(buffers_[0] + indices[0]),
-                            utils::toPolyFloatFromUnaligned(buffers_[1] + indices[1]), 0.0f, 0.0f);
+        const mono_float* left = buffers_[0] + indices[0];
+        const mono_float* right = buffers_[1] + indices[1];
+        matrix value_matrix(utils::toPolyFloatFromUnaligned(left, left),
+                            utils::toPolyFloatFromUnaligned(right, right), 0.0f, 0.0f);
         value_matrix.transpose();
         return interpolation_matrix.multiplyAndSumRows(value_matrix);
       }
@@ -95,6 +95,26 @@ namespace vital {
     current_data_->sample_rate = rate;
   }
 
+  void Wavetable::copy(const Wavetable* other) {
+    const WavetableData* other_data = other->current_data_;
+    int num_frames = other_data->num_frames;
+    setNumFrames(num_frames);
+
+    memcpy(current_data_->wave_data[0], other_data->wave_data[0], num_frames * kWaveformSize * sizeof(mono_float));
+    int frequency_values = num_frames * kPolyFrequencySize;
+    std::copy(other_data->frequency_amplitudes[0], other_data->frequency_amplitudes[0] + frequency_values,
+              current_data_->frequency_amplitudes[0]);
+    std::copy(other_data->normalized_frequencies[0], other_data->normalized_frequencies[0] + frequency_values,
+              current_data_->normalized_frequencies[0]);
+    std::copy(other_data->phases[0], other_data->phases[0] + frequency_values, current_data_->phases[0]);
+    current_data_->frequency_ratio = other_data->frequency_ratio;
+    current_data_->sample_rate = other_data->sample_rate;
+
+    shepard_table_ = other->shepard_table_;
+    name_ = other->name_;
+    author_ = other->author_;
+  }
+
   void Wavetable::loadWaveFrame(const WaveFrame* wave_frame) {
     loadWaveFrame(wave_frame, wave_frame->index);
   }
@@ -121,6 +121,7 @@ namespace vital {
         return active_audio_data_.load()->version;
       }
 
+      void copy(const Wavetable* other);
       void loadWaveFrame(const WaveFrame* wave_frame);
       void loadWaveFrame(const WaveFrame* wave_frame, int to_index);
       void postProcess(float max_span);
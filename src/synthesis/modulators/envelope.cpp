@@ -16,6 +16,7 @@
 
 #include "envelope.h"
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -24,6 +25,12 @@ namespace vital {
       position_(0.0f), value_(0.0f), poly_state_(0.0f), start_value_(0.0f),
       attack_power_(0.0f), decay_power_(0.0f), release_power_(0.0f), sustain_(0.0f) { }
 
+  void Envelope::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(current_value_, position_, value_, poly_state_, start_value_);
+    snapshot.copy(attack_power_, decay_power_, release_power_, sustain_);
+    Processor::copyState(snapshot);
+  }
+
   void Envelope::process(int num_samples) {
     if (isControlRate())
       processControlRate(num_samples);
@@ -17,11 +17,17 @@
 #include "line_map.h"
 
 #include "line_generator.h"
+#include "processor_snapshot.h"
 #include "utils.h"
 
 namespace vital {
   LineMap::LineMap(LineGenerator* source) : Processor(1, kNumOutputs, true), source_(source) { }
 
+  void LineMap::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(offset_);
+    Processor::copyState(snapshot);
+  }
+
   void LineMap::process(int num_samples) {
     process(input()->at(0));
   }
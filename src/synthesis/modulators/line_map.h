@@ -36,6 +36,7 @@ namespace vital {
 
       virtual Processor* clone() const override { return new LineMap(*this); }
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void process(poly_float phase);
 
     protected:
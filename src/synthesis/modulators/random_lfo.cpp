@@ -16,6 +16,7 @@
 
 #include "random_lfo.h"
 
+#include "processor_snapshot.h"
 #include "synth_lfo.h"
 #include "utils.h"
 #include "futils.h"
@@ -106,6 +107,12 @@ namespace vital {
     return 0;
   }
 
+  void RandomLfo::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(state_, *shared_state_, random_generator_.engine(), last_value_);
+    snapshot.copy(*sync_seconds_, *last_sync_);
+    Processor::copyState(snapshot);
+  }
+
   void RandomLfo::process(int num_samples) {
     if (input(kSync)->at(0)[0]) {
       if (*last_sync_ != *sync_seconds_) {
@@ -113,13 +120,10 @@ namespace vital {
 
         poly_float* dest = output()->buffer;
         int update_samples = isControlRate() ? 1 : num_samples;
-        for (int i = 0; i < update_samples; ++i) {
-          poly_float value = dest[i] & constants::kFirstMask;
-          dest[i] = value + utils::swapVoices(value);
-        }
+        for (int i = 0; i < update_samples; ++i)
+          dest[i] = utils::copyFirstVoice(dest[i]);
 
-        poly_float trigger_value = output()->trigger_value & constants::kFirstMask;
-        output()->trigger_value = trigger_value + utils::swapVoices(trigger_value);
+        output()->trigger_value = utils::copyFirstVoice(output()->trigger_value);
         *last_sync_ = *sync_seconds_;
       }
     }
@@ -64,6 +64,7 @@ namespace vital {
 
       virtual Processor* clone() const override { return new RandomLfo(*this); }
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void process(RandomState* state, int num_samples);
       void processSampleAndHold(RandomState* state, int num_samples);
       void processLorenzAttractor(RandomState* state, int num_samples);
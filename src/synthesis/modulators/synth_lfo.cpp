@@ -18,6 +18,7 @@
 
 #include "common.h"
 #include "line_generator.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 #include "utils.h"
 
@@ -429,6 +430,12 @@ namespace vital {
     output(kOscFrequency)->buffer[0] = frequency;
   }
 
+  void SynthLfo::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(was_control_rate_, control_rate_state_, audio_rate_state_);
+    snapshot.copy(held_mask_, trigger_sample_, trigger_delay_, *sync_seconds_);
+    Processor::copyState(snapshot);
+  }
+
   void SynthLfo::process(int num_samples) {
     bool control_rate = isControlRate();
     if (was_control_rate_ && !control_rate)
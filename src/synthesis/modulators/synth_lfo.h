@@ -106,6 +106,7 @@ namespace vital {
       virtual Processor* clone() const override { return new SynthLfo(*this); }
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void correctToTime(double seconds);
 
     protected:
@@ -16,12 +16,19 @@
 
 #include "trigger_random.h"
 
+#include "processor_snapshot.h"
+
 #include <cstdlib>
 
 namespace vital {
 
   TriggerRandom::TriggerRandom() : Processor(1, 1, true), value_(0.0f), random_generator_(0.0f, 1.0f) { }
 
+  void TriggerRandom::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(value_, random_generator_.engine());
+    Processor::copyState(snapshot);
+  }
+
   void TriggerRandom::process(int num_samples) {
     poly_mask trigger_mask = getResetMask(kReset);
     if (trigger_mask.anyMask()) {
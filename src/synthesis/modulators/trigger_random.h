@@ -33,6 +33,7 @@ namespace vital {
 
       virtual Processor* clone() const override { return new TriggerRandom(*this); }
       virtual void process(int num_samples) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
     private:
       poly_float value_;
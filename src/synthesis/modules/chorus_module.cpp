@@ -18,6 +18,7 @@
 
 #include "delay.h"
 #include "memory.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 namespace vital {
@@ -158,4 +159,13 @@ namespace vital {
   void ChorusModule::correctToTime(double seconds) {
     phase_ = utils::getCycleOffsetFromSeconds(seconds, frequency_->buffer[0]);
   }
+
+  void ChorusModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(last_num_voices_, phase_, wet_, dry_);
+    for (int i = 0; i < kMaxDelayPairs; ++i) {
+      snapshot.copyOutput(&delay_status_outputs_[i]);
+      snapshot.copyProcessor(&delay_frequencies_[i]);
+    }
+    SynthModule::copyState(snapshot);
+  }
 } // namespace vital
@@ -18,6 +18,7 @@
 
 #include "distortion.h"
 #include "digital_svf.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -86,4 +87,9 @@ namespace vital {
       audio_out[i] = utils::interpolate(audio_in[i], audio_out[i], current_mix);
     }
   }
+
+  void DistortionModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(mix_);
+    SynthModule::copyState(snapshot);
+  }
 } // namespace vital
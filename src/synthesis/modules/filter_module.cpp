@@ -23,6 +23,7 @@
 #include "formant_module.h"
 #include "ladder_filter.h"
 #include "phaser_filter.h"
+#include "processor_snapshot.h"
 #include "sallen_key_filter.h"
 #include "synth_constants.h"
 
@@ -237,6 +238,11 @@ namespace vital {
       utils::zeroBuffer(output()->buffer, num_samples);
   }
 
+  void FilterModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(last_model_, was_on_, mix_);
+    SynthModule::copyState(snapshot);
+  }
+
   void FilterModule::setMono(bool mono) {
     mono_ = mono;
     formant_filter_->setMono(mono);
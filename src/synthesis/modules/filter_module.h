@@ -49,6 +49,7 @@ namespace vital {
                                Output* internal_modulation = nullptr);
       void init() override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       virtual Processor* clone() const override {
         FilterModule* newModule = new FilterModule(*this);
         newModule->last_model_ = -1;
@@ -18,6 +18,7 @@
 
 #include "delay.h"
 #include "memory.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 namespace vital {
@@ -80,4 +81,10 @@ namespace vital {
   void FlangerModule::correctToTime(double seconds) {
     phase_ = utils::getCycleOffsetFromSeconds(seconds, frequency_->buffer[0]);
   }
+
+  void FlangerModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(phase_);
+    snapshot.copyProcessor(&delay_frequency_);
+    SynthModule::copyState(snapshot);
+  }
 } // namespace vital
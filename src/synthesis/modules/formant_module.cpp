@@ -15,6 +15,7 @@
  */
 
 #include "formant_module.h"
+#include "processor_snapshot.h"
 #include "vocal_tract.h"
 
 namespace vital {
@@ -84,6 +85,11 @@ namespace vital {
     getLocalProcessor(formant_filters_[last_style_])->hardReset();
   }
 
+  void FormantModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(last_style_);
+    SynthModule::copyState(snapshot);
+  }
+
   force_inline void FormantModule::setStyle(int new_style) {
     if (last_style_ == new_style)
       return;
@@ -40,6 +40,7 @@ namespace vital {
       void process(int num_samples) override;
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void setMono(bool mono) { mono_ = mono; }
       virtual Processor* clone() const override { return new FormantModule(*this); }
 
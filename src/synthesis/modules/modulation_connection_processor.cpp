@@ -16,6 +16,7 @@
 
 #include "modulation_connection_processor.h"
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -64,6 +65,11 @@ namespace vital {
       processAudioRate(num_samples, source);
   }
 
+  void ModulationConnectionProcessor::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(power_, modulation_amount_, last_destination_scale_);
+    SynthModule::copyState(snapshot);
+  }
+
   void ModulationConnectionProcessor::processAudioRate(int num_samples, const Output* source) {
     if (bypass_->value()) {
       output(kModulationOutput)->clearBuffer();
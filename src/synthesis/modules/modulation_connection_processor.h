@@ -43,6 +43,7 @@ namespace vital {
 
       void init() override;
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void processAudioRate(int num_samples, const Output* source);
       void processAudioRateLinear(int num_samples, const Output* source);
       void processAudioRateRemapped(int num_samples, const Output* source);
@@ -16,6 +16,7 @@
 
 #include "oscillator_module.h"
 
+#include "processor_snapshot.h"
 #include "synth_oscillator.h"
 #include "wavetable.h"
 
@@ -111,4 +112,9 @@ namespace vital {
 
     *was_on_ = on;
   }
+
+  void OscillatorModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(*was_on_);
+    SynthModule::copyState(snapshot);
+  }
 } // namespace vital
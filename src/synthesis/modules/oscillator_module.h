@@ -42,6 +42,7 @@ namespace vital {
       virtual ~OscillatorModule() { }
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void init() override;
       virtual Processor* clone() const override { return new OscillatorModule(*this); }
 
@@ -60,6 +60,8 @@ namespace vital {
       }
 
       Sample* getSample() { return sampler_->getSample(); }
+      Output* oscillatorOutput(int index) { return oscillators_[index]->output(OscillatorModule::kLevelled); }
+      Output* sampleOutput() { return sampler_->output(SampleModule::kLevelled); }
       Output* samplePhaseOutput() { return sampler_->getPhaseOutput(); }
       void setFilter1On(const Value* on) { filter1_on_ = on; }
       void setFilter2On(const Value* on) { filter2_on_ = on; }
@@ -24,6 +24,7 @@
 #include "flanger_module.h"
 #include "filter_module.h"
 #include "phaser_module.h"
+#include "processor_snapshot.h"
 #include "reverb_module.h"
 #include "synth_strings.h"
 
@@ -143,6 +144,11 @@ namespace vital {
       effects_[i]->hardReset();
   }
 
+  void ReorderableEffectChain::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(effect_order_, last_order_);
+    SynthModule::copyState(snapshot);
+  }
+
   void ReorderableEffectChain::correctToTime(double seconds) {
     for (int i = 0; i < constants::kNumEffects; ++i)
       effects_[i]->correctToTime(seconds);
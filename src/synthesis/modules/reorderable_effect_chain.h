@@ -36,6 +36,7 @@ namespace vital {
 
       virtual void process(int num_samples) override;
       virtual void hardReset() override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
       virtual Processor* clone() const override { return new ReorderableEffectChain(*this); }
 
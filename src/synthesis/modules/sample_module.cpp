@@ -16,6 +16,7 @@
 
 #include "sample_module.h"
 
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 namespace vital {
@@ -69,4 +70,9 @@ namespace vital {
 
     *was_on_ = on;
   }
+
+  void SampleModule::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(*was_on_);
+    SynthModule::copyState(snapshot);
+  }
 } // namespace vital
@@ -39,6 +39,7 @@ namespace vital {
       virtual ~SampleModule() { }
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void init() override;
       virtual Processor* clone() const override { return new SampleModule(*this); }
 
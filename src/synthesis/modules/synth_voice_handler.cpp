@@ -22,6 +22,7 @@
 #include "line_map.h"
 #include "operators.h"
 #include "portamento_slope.h"
+#include "processor_snapshot.h"
 #include "random_lfo_module.h"
 #include "synth_constants.h"
 #include "lfo_module.h"
@@ -45,6 +46,11 @@ namespace vital {
     direct_output_ = new Multiply();
     registerOutput(direct_output_->output());
 
+    for (int i = 0; i <= kNumOscillators; ++i) {
+      stem_outputs_[i] = new Multiply();
+      registerOutput(stem_outputs_[i]->output());
+    }
+
     note_from_reference_ = new cr::Add();
     midi_offset_output_ = registerControlRateOutput(note_from_reference_->output(), true);
 
@@ -70,6 +76,15 @@ namespace vital {
     addProcessor(output_);
     addProcessor(direct_output_);
 
+    for (int i = 0; i <= kNumOscillators; ++i) {
+      if (i < kNumOscillators)
+        stem_outputs_[i]->plug(producers_->oscillatorOutput(i), 0);
+      else
+        stem_outputs_[i]->plug(producers_->sampleOutput(), 0);
+      stem_outputs_[i]->plug(amplitude_, 1);
+      addProcessor(stem_outputs_[i]);
+    }
+
     Output* macros[kNumMacros];
     for (int i = 0; i < kNumMacros; ++i)
       macros[i] = createMonoModControl("macro_control_" + std::to_string(i + 1));
@@ -96,6 +111,7 @@ namespace vital {
     }
 
     VoiceHandler::init();
+    enableStems(false);
     producers_->setFilter1On(filters_module_->getFilter1OnValue());
     producers_->setFilter2On(filters_module_->getFilter2OnValue());
     setupPolyModulationReadouts();
@@ -132,6 +148,16 @@ namespace vital {
     }
   }
 
+  void SynthVoiceHandler::enableStems(bool enable) {
+    for (int i = 0; i <= kNumOscillators; ++i) {
+      stem_outputs_[i]->enable(enable);
+      if (enable)
+        setActiveAccumulatedOutput(stem_outputs_[i]->output());
+      else
+        setInactiveAccumulatedOutput(stem_outputs_[i]->output());
+    }
+  }
+
   void SynthVoiceHandler::prepareDestroy() {
     for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
       ModulationConnectionProcessor* processor = modulation_bank_.atIndex(i)->modulation_processor.get();
@@ -325,20 +351,23 @@ namespace vital {
 
       for (ModulationConnectionProcessor* processor : enabled_modulation_processors_) {
         poly_float* buffer = processor->output()->buffer;
-        if (processor->isControlRate() || processor->isPolyphonicModulation()) {
-          poly_float masked_value = buffer[0] & last_active_voice_mask_;
-          buffer[0] = masked_value + utils::swapVoices(masked_value);
-        }
+        if (processor->isControlRate() || processor->isPolyphonicModulation())
+          buffer[0] = utils::sumVoices(buffer[0] & last_active_voice_mask_);
         else {
-          for (int i = 0; i < num_samples; ++i) {
-            poly_float masked_value = buffer[i] & last_active_voice_mask_;
-            buffer[i] = masked_value + utils::swapVoices(masked_value);
-          }
+          for (int i = 0; i < num_samples; ++i)
+            buffer[i] = utils::sumVoices(buffer[i] & last_active_voice_mask_);
         }
       }
     }
   }
 
+  void SynthVoiceHandler::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copyOutput(&note_retriggered_);
+    snapshot.copyOutput(&num_voices_);
+    snapshot.copy(last_active_voice_mask_);
+    VoiceHandler::copyState(snapshot);
+  }
+
   void SynthVoiceHandler::noteOn(int note, mono_float velocity, int sample, int channel) {
     if (getNumPressedNotes() < polyphony() || !legato())
       note_retriggered_.trigger(constants::kFullMask, note, sample);
@@ -46,6 +46,7 @@ namespace vital {
       void prepareDestroy();
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void noteOn(int note, mono_float velocity, int sample, int channel) override;
       void noteOff(int note, mono_float lift, int sample, int channel) override;
       bool shouldAccumulate(Output* output) override;
@@ -59,6 +60,8 @@ namespace vital {
       Sample* getSample() { return producers_->getSample(); }
       LineGenerator* getLfoSource(int index) { return &lfo_sources_[index]; }
       Output* getDirectOutput() { return getAccumulatedOutput(direct_output_->output()); }
+      Output* getStemOutput(int index) { return getAccumulatedOutput(stem_outputs_[index]->output()); }
+      void enableStems(bool enable);
 
       Output* note_retrigger() { return &note_retriggered_; }
 
@@ -117,6 +120,10 @@ namespace vital {
 
       Multiply* output_;
       Multiply* direct_output_;
+      // Each oscillator, then the sample, after the amplitude envelope but
+      // before any filter. Only processed and summed over the voices while
+      // stems are enabled.
+      Multiply* stem_outputs_[kNumOscillators + 1];
       Output num_voices_;
 
       output_map poly_readouts_;
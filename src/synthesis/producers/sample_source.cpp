@@ -16,6 +16,7 @@
 
 #include "sample_source.h"
 #include "futils.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 
 #include <thread>
@@ -196,6 +197,30 @@ namespace vital {
         dest[i] = getFilteredLoopSample(original, 2 * i, original_size);
     }
 
+    // Lengths of the buffers createBandLimitedBuffers makes for a sample of size samples.
+    std::vector<int> bandLimitedBufferSizes(int size) {
+      std::vector<int> sizes;
+      for (int i = Sample::kUpsampleTimes; i > 0; --i)
+        sizes.push_back((size << i) + 2 * Sample::kBufferSamples);
+
+      sizes.push_back(size + 2 * Sample::kBufferSamples);
+      int current_size = size;
+      while (current_size >= Sample::kMinSize) {
+        current_size = (current_size + 1) / 2;
+        sizes.push_back(current_size + 2 * Sample::kBufferSamples);
+      }
+      return sizes;
+    }
+
+    void copyBuffers(std::vector<std::unique_ptr<mono_float[]>>& destination,
+                     const std::vector<std::unique_ptr<mono_float[]>>& source, const std::vector<int>& sizes) {
+      VITAL_ASSERT(source.empty() || source.size() == sizes.size());
+      for (size_t i = 0; i < source.size(); ++i) {
+        destination.push_back(std::make_unique<mono_float[]>(sizes[i]));
+        memcpy(destination.back().get(), source[i].get(), sizes[i] * sizeof(mono_float));
+      }
+    }
+
     void createBandLimitedBuffers(std::vector<std::unique_ptr<mono_float[]>>& destination,
                                   std::vector<std::unique_ptr<mono_float[]>>& loop_destination,
                                   const mono_float* buffer, int size) {
@@ -267,6 +292,26 @@ namespace vital {
     init();
   }
 
+  void Sample::copy(const Sample* other) {
+    VITAL_ASSERT(active_audio_data_.is_lock_free());
+
+    const SampleData* other_data = other->current_data_;
+    std::vector<int> sizes = bandLimitedBufferSizes(other_data->length);
+
+    std::unique_ptr<SampleData> old_data = std::move(data_);
+    data_ = std::make_unique<SampleData>(other_data->length, other_data->sample_rate, other_data->stereo);
+    copyBuffers(data_->left_buffers, other_data->left_buffers, sizes);
+    copyBuffers(data_->left_loop_buffers, other_data->left_loop_buffers, sizes);
+    copyBuffers(data_->right_buffers, other_data->right_buffers, sizes);
+    copyBuffers(data_->right_loop_buffers, other_data->right_loop_buffers, sizes);
+    name_ = other->name_;
+    last_browsed_file_ = other->last_browsed_file_;
+
+    current_data_ = data_.get();
+    while (active_audio_data_.load())
+      std::this_thread::yield(); // Wait for audio thread to finish using old_data.
+  }
+
   void Sample::loadSample(const mono_float* buffer, int size, int sample_rate) {
     static constexpr int kMaxSize = 1764000;
 
@@ -402,8 +447,7 @@ namespace vital {
     
     poly_float reset_value = -reset_offset;
     if (input(kRandomPhase)->at(0)[0]) {
-      reset_value = random_generator_.next() * audio_length;
-      reset_value = utils::maskLoad(reset_value, random_generator_.next() * audio_length, constants::kFirstMask);
+      reset_value = random_generator_.polyVoiceNext() * audio_length;
       reset_value -= reset_offset;
     }
     
@@ -512,6 +556,14 @@ namespace vital {
     sample_->markUnused();
   }
 
+  void SampleSource::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(pan_amplitude_, transpose_quantize_, last_quantized_transpose_);
+    snapshot.copy(sample_index_, sample_fraction_, phase_inc_, bounce_mask_);
+    snapshot.copy(random_generator_.engine());
+    snapshot.copyOutput(phase_output_.get());
+    Processor::copyState(snapshot);
+  }
+
   force_inline poly_float SampleSource::snapTranspose(poly_float input_midi, poly_float transpose, int quantize) {
     if (quantize == 0)
       return input_midi + transpose;
@@ -47,6 +47,7 @@ namespace vital {
     
       Sample();
 
+      void copy(const Sample* other);
       void loadSample(const mono_float* buffer, int size, int sample_rate);
       void loadSample(const mono_float* left_buffer, const mono_float* right_buffer, int size, int sample_rate);
       void setName(const std::string& name) { name_ = name; }
@@ -57,6 +58,15 @@ namespace vital {
       force_inline int originalLength() const { return current_data_->length; }
       force_inline int upsampleLength() { return originalLength() * (1 << kUpsampleTimes); }
       force_inline int sampleRate() const { return current_data_->sample_rate; }
+      force_inline bool isStereo() const { return current_data_->stereo; }
+
+      // The sample as loaded, before resampling, originalLength() frames long.
+      force_inline const mono_float* originalLeftBuffer() const {
+        return current_data_->left_buffers[kUpsampleTimes].get() + kBufferSamples;
+      }
+      force_inline const mono_float* originalRightBuffer() const {
+        return current_data_->right_buffers[kUpsampleTimes].get() + kBufferSamples;
+      }
 
       force_inline int activeLength() const { return active_audio_data_.load()->length * (1 << kUpsampleTimes); }
       force_inline int activeSampleRate() const { return active_audio_data_.load()->sample_rate; }
@@ -147,6 +157,7 @@ namespace vital {
       SampleSource();
 
       virtual void process(int num_samples) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
       virtual Processor* clone() const override { return new SampleSource(*this); }
       Sample* getSample() { return sample_.get(); }
       force_inline Output* getPhaseOutput() const { return phase_output_.get(); }
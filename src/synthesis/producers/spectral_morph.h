@@ -32,6 +32,43 @@ namespace vital {
   static constexpr mono_float kSkewScale = 16.0f;
   static constexpr int kMaxPolyIndex = WaveFrame::kWaveformSize / poly_float::kSize;
 
+  // Spectra hold each harmonic's real and imaginary values side by side, so a
+  // poly_float holds kSize / 2 harmonics. The morphs cut harmonics off and fade
+  // them in pairs, the way four lanes group them, so wider values still make
+  // the same waveforms.
+  static constexpr int kHarmonicsPerPoly = poly_float::kSize / 2;
+  static constexpr int kPairValues = 4;
+
+  static const poly_float kLaneHarmonics = []() {
+    poly_float harmonics = 0.0f;
+    for (size_t i = 0; i < poly_float::kSize; ++i)
+      harmonics.set(i, i / 2);
+    return harmonics;
+  }();
+
+  static force_inline poly_float harmonicIndices(int poly_index) {
+    return kLaneHarmonics + kHarmonicsPerPoly * poly_index;
+  }
+
+  // Clears the harmonics a wider value filled in past last_harmonic's pair.
+  static force_inline void clearPastHarmonicPair(poly_float* wave_start, int last_harmonic) {
+    mono_float* values = (mono_float*)wave_start;
+    int last_index = 2 * last_harmonic / poly_float::kSize;
+    int end = poly_float::kSize * (last_index + 1);
+    for (int i = kPairValues * (last_harmonic / 2 + 1); i < end; ++i)
+      values[i] = 0.0f;
+  }
+
+  // Each harmonic takes the even, real lane's random value of its pair.
+  static force_inline poly_float loadHarmonicRandoms(const mono_float* values) {
+    poly_float result;
+    for (size_t i = 0; i < poly_float::kSize; i += 2) {
+      result.set(i, values[i]);
+      result.set(i + 1, values[i]);
+    }
+    return result;
+  }
+
   static force_inline void transformAndWrapBuffer(FourierTransform* transform, mono_float* buffer) {
     transform->transformRealInverse(buffer + poly_float::kSize);
 
@@ -64,6 +101,7 @@ namespace vital {
 
     for (int i = last_index + 1; i < kMaxPolyIndex; ++i)
       wave_start[i] = 0.0f;
+    clearPastHarmonicPair(wave_start, last_harmonic);
 
     transformAndWrapBuffer(transform, dest);
   }
@@ -87,6 +125,7 @@ namespace vital {
 
     for (int i = last_index + 1; i < kMaxPolyIndex; ++i)
       poly_wave_start[i] = 0.0f;
+    clearPastHarmonicPair(poly_wave_start, last_harmonic);
 
     const mono_float* frequency_amplitudes = (const mono_float*)wavetable_data->frequency_amplitudes[wavetable_index];
     const mono_float* normalized = (const mono_float*)wavetable_data->normalized_frequencies[wavetable_index];
@@ -189,13 +228,12 @@ namespace vital {
     int last_index = 2 * last_harmonic / poly_float::kSize;
 
     float offset = -(kCenterMorph - 1.0f) * (kCenterMorph - 1.0f) * phase_shift;
-    poly_float value_offset(0.0f, 0.0f, 1.0f, 1.0f);
     poly_float phase_offset(0.25f, 0.0f, 0.25f, 0.0f);
     poly_float scale = 0.5f / kPi;
     for (int i = 0; i <= last_index; ++i) {
       poly_float amplitude = frequency_amplitudes[i];
       poly_float normalized = normalized_frequencies[i];
-      poly_float index = value_offset + 2.0f * i;
+      poly_float index = harmonicIndices(i);
 
       poly_float delta_center = (index - kCenterMorph) * (index - kCenterMorph) * phase_shift + offset;
       poly_float phase = utils::mod(delta_center * scale + phase_offset);
@@ -210,6 +248,7 @@ namespace vital {
     }
     for (int i = last_index + 1; i < kMaxPolyIndex; ++i)
       wave_start[i] = 0.0f;
+    clearPastHarmonicPair(wave_start, last_harmonic);
 
     transformAndWrapBuffer(transform, dest);
   }
@@ -217,24 +256,31 @@ namespace vital {
   static void smearMorph(const Wavetable::WavetableData* wavetable_data,
                          int wavetable_index, poly_float* dest, FourierTransform* transform,
                          float smear, int last_harmonic, const poly_float* data_buffer) {
-    const poly_float* frequency_amplitudes = wavetable_data->frequency_amplitudes[wavetable_index];
-    const poly_float* normalized_frequencies = wavetable_data->normalized_frequencies[wavetable_index];
+    const mono_float* amplitudes = (const mono_float*)wavetable_data->frequency_amplitudes[wavetable_index];
+    const mono_float* normalized = (const mono_float*)wavetable_data->normalized_frequencies[wavetable_index];
 
-    poly_float* wave_start = dest + 1;
-    int last_index = 2 * last_harmonic / poly_float::kSize;
+    mono_float* wave_start = (mono_float*)(dest + 1);
+    int last_pair = last_harmonic / 2;
 
-    poly_float amplitude = frequency_amplitudes[0] * (1.0f - smear);
-    wave_start[0] = amplitude * normalized_frequencies[0];
+    // Each harmonic smears into the one two above it.
+    mono_float amplitude[kPairValues];
+    for (int v = 0; v < kPairValues; ++v) {
+      amplitude[v] = amplitudes[v] * (1.0f - smear);
+      wave_start[v] = amplitude[v] * normalized[v];
+    }
 
-    for (int i = 1; i <= last_index; ++i) {
-      poly_float original_amplitude = frequency_amplitudes[i];
-      amplitude = utils::interpolate(original_amplitude, amplitude, smear);
+    for (int i = 1; i <= last_pair; ++i) {
+      float mult = (i + 0.25f) / i;
+      for (int v = 0; v < kPairValues; ++v) {
+        int index = kPairValues * i + v;
+        amplitude[v] = utils::interpolate(amplitudes[index], amplitude[v], smear);
 
-      wave_start[i] = amplitude * normalized_frequencies[i];
-      amplitude *= (i + 0.25f) / i;
+        wave_start[index] = amplitude[v] * normalized[index];
+        amplitude[v] *= mult;
+      }
     }
 
-    for (int i = last_index + 1; i < kMaxPolyIndex; ++i)
+    for (int i = kPairValues * (last_pair + 1); i < WaveFrame::kWaveformSize; ++i)
       wave_start[i] = 0.0f;
 
     transformAndWrapBuffer(transform, dest);
@@ -249,9 +295,8 @@ namespace vital {
     poly_float* wave_start = dest + 1;
     float cutoff = futils::pow(2.0f, (Wavetable::kFrequencyBins - 1) * cutoff_t) + 1.0f;
     int last_index = 2 * last_harmonic / poly_float::kSize;
-    float poly_cutoff = std::min(last_index + 1.0f, 2.0f * cutoff / poly_float::kSize);
-    last_index = std::min<int>(last_index, poly_cutoff);
-    float t = poly_float::kSize * (poly_cutoff - last_index) / 2.0f;
+    float harmonic_cutoff = std::min(2.0f * (last_harmonic / 2 + 1), cutoff);
+    last_index = std::min<int>(last_index, harmonic_cutoff / kHarmonicsPerPoly);
 
     for (int i = 0; i <= last_index; ++i)
       wave_start[i] = frequency_amplitudes[i] * normalized_frequencies[i];
@@ -259,12 +304,7 @@ namespace vital {
     for (int i = last_index + 1; i <= kMaxPolyIndex; ++i)
       wave_start[i] = 0.0f;
 
-    poly_float last_mult = 1.0f;
-    if (t >= 1.0f)
-      last_mult = poly_float(1.0f, 1.0f, t - 1.0f, t - 1.0f);
-    else
-      last_mult = poly_float(t, t, 0.0f, 0.0f);
-
+    poly_float last_mult = utils::clamp(poly_float(harmonic_cutoff) - harmonicIndices(last_index), 0.0f, 1.0f);
     wave_start[last_index] = wave_start[last_index] * last_mult;
 
     transformAndWrapBuffer(transform, dest);
@@ -280,9 +320,8 @@ namespace vital {
     float cutoff = futils::pow(2.0f, (Wavetable::kFrequencyBins - 1) * cutoff_t);
     cutoff *= (kNumHarmonics + 1.0f) / kNumHarmonics;
     int last_index = 2 * last_harmonic / poly_float::kSize;
-    float poly_cutoff = std::min(last_index + 1.0f, 2.0f * cutoff / poly_float::kSize);
-    int start_index = poly_cutoff;
-    float t = poly_float::kSize * (poly_cutoff - start_index) / 2.0f;
+    float harmonic_cutoff = std::min(2.0f * (last_harmonic / 2 + 1), cutoff);
+    int start_index = harmonic_cutoff / kHarmonicsPerPoly;
 
     for (int i = 0; i < start_index; ++i)
       wave_start[i] = 0.0f;
@@ -293,13 +332,9 @@ namespace vital {
     for (int i = last_index + 1; i <= kMaxPolyIndex; ++i)
       wave_start[i] = 0.0f;
 
-    poly_float last_mult = 1.0f;
-    if (t >= 1.0f)
-      last_mult = poly_float(0.0f, 0.0f, 2.0f - t, 2.0f - t);
-    else
-      last_mult = poly_float(1.0f - t, 1.0f - t, 1.0f, 1.0f);
-
-    wave_start[start_index] = wave_start[start_index] * last_mult;
+    poly_float last_mult = poly_float(1.0f) - (poly_float(harmonic_cutoff) - harmonicIndices(start_index));
+    wave_start[start_index] = wave_start[start_index] * utils::clamp(last_mult, 0.0f, 1.0f);
+    clearPastHarmonicPair(wave_start, last_harmonic);
 
     transformAndWrapBuffer(transform, dest);
   }
@@ -391,15 +426,12 @@ namespace vital {
                                    float mult, int last_harmonic, const poly_float* data_buffer) {
     poly_float* poly_data_start = dest + 2 + kMaxPolyIndex;
 
-    poly_float offset(0.0f, 2.0f, 1.0f, 3.0f);
-    for (int i = 0; i <= kMaxPolyIndex / 2; ++i) {
-      poly_float index = offset + i * 4;
+    for (int i = 0; i <= kMaxPolyIndex + 1; ++i) {
+      poly_float index = harmonicIndices(i);
       poly_float octave = futils::log2(index);
       poly_float power = octave * (1.0f / (Wavetable::kFrequencyBins - 1.0f));
       poly_float shift = futils::pow(mult, power);
-      poly_float shifted_index = utils::max(1.0f, shift * (index - 1.0f) + 1.0f);
-      poly_data_start[2 * i] = shifted_index;
-      poly_data_start[2 * i + 1] = utils::swapStereo(shifted_index);
+      poly_data_start[i] = utils::max(1.0f, shift * (index - 1.0f) + 1.0f);
     }
 
     const mono_float* amplitudes = (const mono_float*)wavetable_data->frequency_amplitudes[wavetable_index];
@@ -455,15 +487,14 @@ namespace vital {
     poly_float center = poly_float(1.0f) - scale;
     poly_float mult = 1.0f + shift;
 
-    const poly_float* buffer1 = data_buffer + index * kNumHarmonics / poly_float::kSize;
-    const poly_float* buffer2 = data_buffer + (index + 1) * kNumHarmonics / poly_float::kSize;
+    const mono_float* random_values = (const mono_float*)data_buffer;
+    const mono_float* buffer1 = random_values + kPairValues * (index * kNumHarmonics / kPairValues);
+    const mono_float* buffer2 = random_values + kPairValues * ((index + 1) * kNumHarmonics / kPairValues);
 
     poly_float random_t(amount, 1.0f - amount, amount, 1.0f - amount);
     for (int i = 0; i <= last_index; ++i) {
-      poly_float random_value1 = buffer1[i] & constants::kLeftMask;
-      random_value1 = random_value1 + utils::swapStereo(random_value1);
-      poly_float random_value2 = buffer2[i] & constants::kLeftMask;
-      random_value2 = random_value2 + utils::swapStereo(random_value2);
+      poly_float random_value1 = loadHarmonicRandoms(buffer1 + i * poly_float::kSize);
+      poly_float random_value2 = loadHarmonicRandoms(buffer2 + i * poly_float::kSize);
       poly_float random1 = mult * utils::max(center - scale * random_value1, 0.0f);
       poly_float random2 = mult * utils::max(center - scale * random_value2, 0.0f);
       poly_float amplitude = utils::min(utils::interpolate(random1, random2, t) * frequency_amplitudes[i], 1024.0f);
@@ -472,6 +503,7 @@ namespace vital {
     }
     for (int i = last_index + 1; i <= kMaxPolyIndex; ++i)
       wave_start[i] = 0.0f;
+    clearPastHarmonicPair(wave_start, last_harmonic);
 
     transformAndWrapBuffer(transform, dest);
   }
@@ -19,6 +19,7 @@
 #include "fourier_transform.h"
 #include "futils.h"
 #include "matrix.h"
+#include "processor_snapshot.h"
 #include "wavetable.h"
 
 #include <climits>
@@ -34,6 +35,12 @@ namespace vital {
     constexpr mono_float kInvPhaseMult = 1.0f / kFullPhase;
     constexpr mono_float kIntermediateMult = 1 << kIntermediateBits;
     const poly_int kIntermediateMask = (1 << kIntermediateBits) - 1;
+    const poly_float kVoiceIndices = []() {
+      poly_float indices = 0.0f;
+      for (size_t i = 0; i < poly_float::kSize; ++i)
+        indices.set(i, i / 2);
+      return indices;
+    }();
 
     constexpr mono_float kPhaseBits = (8 * sizeof(uint32_t));
     constexpr mono_float kDistortBits = kPhaseBits;
@@ -122,18 +129,10 @@ namespace vital {
       return phase + utils::toInt(phase_offset * kFmPhaseMult) * kMaxFmModulation;
     }
 
-    force_inline poly_int fmPhaseLeft(poly_int phase, poly_float distortion, poly_int,
-                                      const poly_float* modulation, int i) {
-      poly_float mod = modulation[i] & constants::kFirstMask;
-      mod += utils::swapVoices(mod);
-      poly_float phase_offset = mod * distortion;
-      return phase + utils::toInt(phase_offset * kFmPhaseMult) * kMaxFmModulation;
-    }
-    
-    force_inline poly_int fmPhaseRight(poly_int phase, poly_float distortion, poly_int,
+    template<int voice>
+    force_inline poly_int fmPhaseVoice(poly_int phase, poly_float distortion, poly_int,
                                        const poly_float* modulation, int i) {
-      poly_float mod = modulation[i] & constants::kSecondMask;
-      mod += utils::swapVoices(mod);
+      poly_float mod = utils::sumVoices(modulation[i] & poly_float::equal(kVoiceIndices, voice));
       poly_float phase_offset = mod * distortion;
       return phase + utils::toInt(phase_offset * kFmPhaseMult) * kMaxFmModulation;
     }
@@ -155,17 +154,10 @@ namespace vital {
       return utils::interpolate(1.0f, modulation[i], distortion);
     }
 
-    force_inline poly_float rmWindowLeft(poly_int, poly_int, poly_float distortion,
-                                         const poly_float* modulation, int i) {
-      poly_float mod = modulation[i] & constants::kFirstMask;
-      mod += utils::swapVoices(mod);
-      return utils::interpolate(1.0f, mod, distortion);
-    }
-
-    force_inline poly_float rmWindowRight(poly_int, poly_int, poly_float distortion, 
+    template<int voice>
+    force_inline poly_float rmWindowVoice(poly_int, poly_int, poly_float distortion,
                                           const poly_float* modulation, int i) {
-      poly_float mod = modulation[i] & constants::kSecondMask;
-      mod += utils::swapVoices(mod);
+      poly_float mod = utils::sumVoices(modulation[i] & poly_float::equal(kVoiceIndices, voice));
       return utils::interpolate(1.0f, mod, distortion);
     }
 
@@ -463,11 +455,23 @@ namespace vital {
           current_detuned_amplitude, delta_detuned_amplitude);
     }
 
+    // A voice playing alone gets its unison packed into every voice's lanes,
+    // so it takes a kNumVoicesPerProcess-th of the passes. Voice v of the
+    // packed value holds the lone voice's lanes of values[v ^ active voice],
+    // which leaves the lone voice's own lanes where they were.
     template<class T>
     force_inline T compactAndLoadVoice(T* values, poly_mask active_mask) {
       T one = values[0];
       T two = utils::swapVoices(values[1]);
-      return utils::maskLoad(two, one, active_mask);
+      T result = utils::maskLoad(two, one, active_mask);
+      if (kNumVoicesPerProcess > 2) {
+        T three = values[2];
+        T four = utils::swapVoices(values[3]);
+        T upper = utils::maskLoad(four, three, active_mask);
+        poly_mask pair_mask = active_mask | utils::swapVoices(active_mask);
+        result = utils::maskLoad(utils::swapHalves(upper), result, pair_mask);
+      }
+      return result;
     }
 
     template<class T>
@@ -475,17 +479,42 @@ namespace vital {
       T two = utils::swapVoices(value);
       values[0] = utils::maskLoad(values[0], value, active_mask);
       values[1] = utils::maskLoad(values[1], two, active_mask);
+      if (kNumVoicesPerProcess > 2) {
+        T three = utils::swapHalves(value);
+        T four = utils::swapVoices(three);
+        values[2] = utils::maskLoad(values[2], three, active_mask);
+        values[3] = utils::maskLoad(values[3], four, active_mask);
+      }
+    }
+
+    // Copies the active voices' lanes to the idle ones, so a lone voice's
+    // value is in every voice. Active lanes are left alone.
+    template<class T>
+    force_inline T copyActiveVoice(T value, poly_mask active_mask) {
+      T result = utils::maskLoad(utils::swapVoices(value), value, active_mask);
+      if (kNumVoicesPerProcess > 2) {
+        poly_mask pair_mask = active_mask | utils::swapVoices(active_mask);
+        result = utils::maskLoad(utils::swapHalves(result), result, pair_mask);
+      }
+      return result;
+    }
+
+    force_inline int firstActiveVoice(poly_mask active_mask) {
+      for (int v = 0; v < kNumVoicesPerProcess; ++v) {
+        if (active_mask[2 * v])
+          return v;
+      }
+      return 0;
     }
 
     force_inline void compactAndLoadVoice(const mono_float** dest, const mono_float* const* values,
                                           poly_mask active_mask) {
-      const mono_float* const* position1 = values;
-      const mono_float* const* position2 = values + poly_float::kSize;
-      int index = active_mask[0] ? 0 : 2;
-      dest[index] = position1[index];
-      dest[index + 1] = position1[index + 1];
-      dest[(index + 2) % poly_float::kSize] = position2[index];
-      dest[(index + 3) % poly_float::kSize] = position2[index + 1];
+      int voice = firstActiveVoice(active_mask);
+      for (int v = 0; v < kNumVoicesPerProcess; ++v) {
+        const mono_float* const* position = values + (v ^ voice) * poly_float::kSize;
+        dest[2 * v] = position[2 * voice];
+        dest[2 * v + 1] = position[2 * voice + 1];
+      }
     }
 
     void setPowerDistortionValues(poly_float* values, int num_values, float exponent, bool spread) {
@@ -607,6 +636,29 @@ namespace vital {
     }
   }
 
+  void SynthOscillator::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(phases_, detunings_, phase_inc_mults_, from_phase_inc_mults_);
+    snapshot.copy(shepard_double_masks_, shepard_half_masks_);
+    snapshot.copy(waiting_shepard_double_masks_, waiting_shepard_half_masks_);
+    snapshot.copy(pan_amplitude_, center_amplitude_, detuned_amplitude_, midi_note_, distortion_phase_);
+    snapshot.copy(blend_stereo_multiply_, blend_center_multiply_);
+    snapshot.copy(spectral_morph_values_, last_spectral_morph_values_);
+    snapshot.copy(distortion_values_, last_distortion_values_);
+    snapshot.copy(voice_block_, random_generator_.engine());
+    snapshot.copy(transpose_quantize_, last_quantized_transpose_, last_quantize_ratio_);
+    snapshot.copy(unison_, active_oscillators_);
+
+    // The wave buffers point into the wavetable or into our own fourier frames,
+    // so the wavetable has to be the same one. A morph doesn't write every value
+    // the inverse transform reads, so unreferenced frames are kept too.
+    snapshot.require(wavetable_->getVersion());
+    snapshot.copy(wavetable_version_, wave_buffers_, last_buffers_);
+    snapshot.copy(fourier_frames1_, fourier_frames2_);
+
+    snapshot.copyOutput(phase_inc_buffer_.get());
+    Processor::copyState(snapshot);
+  }
+
   void SynthOscillator::setPhaseIncMults() {
     poly_float range = input(kDetuneRange)->at(0);
     poly_float cents = range * input(kUnisonDetune)->at(0);
@@ -911,7 +963,7 @@ namespace vital {
 
   void SynthOscillator::convertVoiceChannels(int num_samples, poly_float* audio_out, poly_mask active_mask) {
     for (int i = 0; i < num_samples; ++i)
-      audio_out[i] += utils::swapVoices(audio_out[i]);
+      audio_out[i] = utils::sumVoices(audio_out[i]);
   }
 
   force_inline void SynthOscillator::resetWavetableBuffers() {
@@ -922,28 +974,30 @@ namespace vital {
     }
   }
 
-  force_inline void SynthOscillator::loadVoiceBlock(VoiceBlock& voice_block, int index, poly_mask active_mask) {
-    bool single_voice = (~active_mask).anyMask();
-    if (single_voice) {
-      voice_block.phase = compactAndLoadVoice(phases_ + 2 * index, active_mask);
-      voice_block.phase_inc_mult = compactAndLoadVoice(phase_inc_mults_ + 2 * index, active_mask);
-      voice_block.from_phase_inc_mult = compactAndLoadVoice(from_phase_inc_mults_ + 2 * index, active_mask);
-      voice_block.shepard_double_mask = compactAndLoadVoice(shepard_double_masks_ + 2 * index, active_mask);
-      voice_block.shepard_half_mask = compactAndLoadVoice(shepard_half_masks_ + 2 * index, active_mask);
-      voice_block.distortion = compactAndLoadVoice(distortion_values_ + 2 * index, active_mask);
-      voice_block.last_distortion = compactAndLoadVoice(last_distortion_values_ + 2 * index, active_mask);
-      poly_int distortion_phase_swap = utils::swapVoices(voice_block.distortion_phase);
-      voice_block.distortion_phase = utils::maskLoad(distortion_phase_swap, voice_block.distortion_phase, active_mask);
-      poly_int last_distortion_phase_swap = utils::swapVoices(voice_block.last_distortion_phase);
-      voice_block.last_distortion_phase = utils::maskLoad(last_distortion_phase_swap, voice_block.last_distortion_phase,
-                                                          active_mask);
-
-      int buffer_index = 2 * index * poly_float::kSize;
+  force_inline void SynthOscillator::loadVoiceBlock(VoiceBlock& voice_block, int index,
+                                                    bool compact, poly_mask active_mask) {
+    if (compact) {
+      int offset = kNumVoicesPerProcess * index;
+      voice_block.phase = compactAndLoadVoice(phases_ + offset, active_mask);
+      voice_block.phase_inc_mult = compactAndLoadVoice(phase_inc_mults_ + offset, active_mask);
+      voice_block.from_phase_inc_mult = compactAndLoadVoice(from_phase_inc_mults_ + offset, active_mask);
+      voice_block.shepard_double_mask = compactAndLoadVoice(shepard_double_masks_ + offset, active_mask);
+      voice_block.shepard_half_mask = compactAndLoadVoice(shepard_half_masks_ + offset, active_mask);
+      voice_block.distortion = compactAndLoadVoice(distortion_values_ + offset, active_mask);
+      voice_block.last_distortion = compactAndLoadVoice(last_distortion_values_ + offset, active_mask);
+      voice_block.distortion_phase = copyActiveVoice(voice_block.distortion_phase, active_mask);
+      voice_block.last_distortion_phase = copyActiveVoice(voice_block.last_distortion_phase, active_mask);
+
+      int buffer_index = offset * poly_float::kSize;
       compactAndLoadVoice(voice_block.from_buffers, last_buffers_ + buffer_index, active_mask);
       compactAndLoadVoice(voice_block.to_buffers, wave_buffers_ + buffer_index, active_mask);
 
-      if ((index + 1) * poly_float::kSize > active_oscillators_) {
-        int zero_index = active_mask[0] ? 2 : 0;
+      int voice = firstActiveVoice(active_mask);
+      for (int v = 1; v < kNumVoicesPerProcess; ++v) {
+        if (2 * (offset + v) < active_oscillators_)
+          continue;
+
+        int zero_index = 2 * (v ^ voice);
         voice_block.from_buffers[zero_index] = Wavetable::null_waveform();
         voice_block.from_buffers[zero_index + 1] = Wavetable::null_waveform();
         voice_block.to_buffers[zero_index] = Wavetable::null_waveform();
@@ -1209,8 +1263,9 @@ namespace vital {
     }
 
     poly_float active_voice = input(kActiveVoices)->at(0);
-    bool left_active = active_voice[0] == 1.0f;
-    bool right_active = active_voice[2] == 1.0f;
+    int single_voice = -1;
+    if (active_voice.sum() == 2.0f)
+      single_voice = firstActiveVoice(poly_float::equal(active_voice, 1.0f));
 
     unison_ = utils::clamp(roundf(input(kUnisonVoices)->at(0)[0]), 1.0f, kMaxUnison);
     setActiveOscillators(unison_ + (unison_ % 2));
@@ -1251,12 +1306,25 @@ namespace vital {
         else
           voice_block_.modulation_buffer = first_mod_oscillator_->buffer;
         
-        if (left_active && right_active)
-          processOscillators<fmPhase, passThroughWindow>(num_samples, distortion_type);
-        else if (left_active)
-          processOscillators<fmPhaseLeft, passThroughWindow>(num_samples, distortion_type);
-        else
-          processOscillators<fmPhaseRight, passThroughWindow>(num_samples, distortion_type);
+        switch (single_voice) {
+          case 0:
+            processOscillators<fmPhaseVoice<0>, passThroughWindow>(num_samples, distortion_type);
+            break;
+          case 1:
+            processOscillators<fmPhaseVoice<1>, passThroughWindow>(num_samples, distortion_type);
+            break;
+      #if VITAL_AVX2
+          case 2:
+            processOscillators<fmPhaseVoice<2>, passThroughWindow>(num_samples, distortion_type);
+            break;
+          case 3:
+            processOscillators<fmPhaseVoice<3>, passThroughWindow>(num_samples, distortion_type);
+            break;
+      #endif
+          default:
+            processOscillators<fmPhase, passThroughWindow>(num_samples, distortion_type);
+            break;
+        }
         break;
       case kRmOscillatorA:
       case kRmOscillatorB:
@@ -1268,12 +1336,25 @@ namespace vital {
         else
           voice_block_.modulation_buffer = first_mod_oscillator_->buffer;
 
-        if (left_active && right_active)
-          processOscillators<passThroughPhase, rmWindow>(num_samples, distortion_type);
-        else if (left_active)
-          processOscillators<passThroughPhase, rmWindowLeft>(num_samples, distortion_type);
-        else
-          processOscillators<passThroughPhase, rmWindowRight>(num_samples, distortion_type);
+        switch (single_voice) {
+          case 0:
+            processOscillators<passThroughPhase, rmWindowVoice<0>>(num_samples, distortion_type);
+            break;
+          case 1:
+            processOscillators<passThroughPhase, rmWindowVoice<1>>(num_samples, distortion_type);
+            break;
+      #if VITAL_AVX2
+          case 2:
+            processOscillators<passThroughPhase, rmWindowVoice<2>>(num_samples, distortion_type);
+            break;
+          case 3:
+            processOscillators<passThroughPhase, rmWindowVoice<3>>(num_samples, distortion_type);
+            break;
+      #endif
+          default:
+            processOscillators<passThroughPhase, rmWindow>(num_samples, distortion_type);
+            break;
+        }
         break;
       default:
         processOscillators<passThroughPhase, passThroughWindow>(num_samples, distortion_type);
@@ -1304,8 +1385,8 @@ namespace vital {
     float sample_inc = 1.0f / num_samples;
     current_midi = utils::maskLoad(current_midi, midi_note_, reset_mask);
     poly_float delta_midi = (midi_note_ - current_midi) * sample_inc;
-    current_midi = utils::maskLoad(utils::swapVoices(current_midi), current_midi, active_mask);
-    delta_midi = utils::maskLoad(utils::swapVoices(delta_midi), delta_midi, active_mask);
+    current_midi = copyActiveVoice(current_midi, active_mask);
+    delta_midi = copyActiveVoice(delta_midi, active_mask);
 
     const poly_float* transpose_buffer = input(kTranspose)->source->buffer;
     const poly_float* tune_buffer = input(kTune)->source->buffer;
@@ -1323,7 +1404,7 @@ namespace vital {
     for (int i = 0; i < num_samples; ++i) {
       poly_float shift_phase = utils::mod(phase_buffer[i]) - 0.5f;
       poly_int phase = utils::toInt(shift_phase * phase_scale);
-      phase_dest[i] = utils::maskLoad(utils::swapVoices(phase), phase, active_mask);
+      phase_dest[i] = copyActiveVoice(phase, active_mask);
 
       current_midi += delta_midi;
 
@@ -1331,7 +1412,7 @@ namespace vital {
       poly_float frequency = base_frequency * futils::midiOffsetToRatio(midi - base_midi);
       poly_mask zero_mask = poly_int::lessThan(i, trigger_sample) & reset_mask;
       poly_float result = (frequency * sample_rate_scale) & ~zero_mask;
-      inc_dest[i] = utils::maskLoad(utils::swapVoices(result), result, active_mask);
+      inc_dest[i] = copyActiveVoice(result, active_mask);
     }
   }
 
@@ -1380,10 +1461,10 @@ namespace vital {
 
     poly_mask wave_buffer_mask = reset_mask | retrigger_mask;
     poly_float buffer_phase_inc = phase_inc_buffer_->buffer[num_samples - 1] * (1.0f / kPhaseMult);
-    if (wave_buffer_mask[0])
-      setWaveBuffers(buffer_phase_inc, 0);
-    if (wave_buffer_mask[2])
-      setWaveBuffers(buffer_phase_inc, 2);
+    for (int v = 0; v < kNumVoicesPerProcess; ++v) {
+      if (wave_buffer_mask[2 * v])
+        setWaveBuffers(buffer_phase_inc, 2 * v);
+    }
 
     if (reset_mask.anyMask())
       reset(reset_mask, trigger_offset);
@@ -1410,7 +1491,9 @@ namespace vital {
     voice_block_.current_buffer_sample &= active_voice_mask;
     while (voice_block_.start_sample < num_samples) {
       poly_int remaining_fade_samples = poly_int(voice_block_.num_buffer_samples) - voice_block_.current_buffer_sample;
-      int min_remaining_fade_samples = std::min(remaining_fade_samples[0], remaining_fade_samples[2]);
+      int min_remaining_fade_samples = remaining_fade_samples[0];
+      for (int v = 1; v < kNumVoicesPerProcess; ++v)
+        min_remaining_fade_samples = std::min<int>(min_remaining_fade_samples, remaining_fade_samples[2 * v]);
       int samples = std::min(min_remaining_fade_samples, num_samples - voice_block_.start_sample);
       voice_block_.end_sample = voice_block_.start_sample + samples;
       processChunk<phaseDistort, window>(current_center_amplitude, current_detuned_amplitude);
@@ -1422,13 +1505,11 @@ namespace vital {
       if (shepard && new_buffer_mask.anyMask())
         doShepardWrap(new_buffer_mask, transpose_quantize_);
 
-      if (new_buffer_mask[0])
-        setWaveBuffers(buffer_phase_inc, 0);
-      if (new_buffer_mask[2])
-        setWaveBuffers(buffer_phase_inc, 2);
-
-      VITAL_ASSERT((int)voice_block_.current_buffer_sample[0] < voice_block_.num_buffer_samples);
-      VITAL_ASSERT((int)voice_block_.current_buffer_sample[2] < voice_block_.num_buffer_samples);
+      for (int v = 0; v < kNumVoicesPerProcess; ++v) {
+        if (new_buffer_mask[2 * v])
+          setWaveBuffers(buffer_phase_inc, 2 * v);
+        VITAL_ASSERT((int)voice_block_.current_buffer_sample[2 * v] < voice_block_.num_buffer_samples);
+      }
     }
 
     if (reset_mask.anyMask())
@@ -1444,8 +1525,10 @@ namespace vital {
     if (active_channels < 2)
       return;
 
-    VITAL_ASSERT(active_channels == 2 || active_channels == 4);
+    VITAL_ASSERT(active_channels % 2 == 0);
     int num_active_voices = active_channels / 2;
+    bool compact = num_active_voices < 2;
+    int num_lane_voices = compact ? 1 : kNumVoicesPerProcess;
     poly_mask active_voice_mask = poly_float::equal(input(kActiveVoices)->at(0), 1.0f);
     int num_samples = voice_block_.end_sample - voice_block_.start_sample;
 
@@ -1455,39 +1538,31 @@ namespace vital {
     poly_float center_amplitude = center_amplitude_;
     poly_float detuned_amplitude = detuned_amplitude_;
 
-    if (num_active_voices < 2) {
-      poly_float current_detuned_swap = utils::swapVoices(current_detuned_amplitude);
-      current_detuned_amplitude = utils::maskLoad(current_detuned_swap, current_detuned_amplitude, active_voice_mask);
+    if (compact) {
+      current_detuned_amplitude = copyActiveVoice(current_detuned_amplitude, active_voice_mask);
       current_center_amplitude = utils::maskLoad(current_detuned_amplitude,
                                                  current_center_amplitude, active_voice_mask);
 
-      poly_float detuned_swap = utils::swapVoices(detuned_amplitude);
-      detuned_amplitude = utils::maskLoad(detuned_swap, detuned_amplitude, active_voice_mask);
+      detuned_amplitude = copyActiveVoice(detuned_amplitude, active_voice_mask);
       center_amplitude = utils::maskLoad(detuned_amplitude, center_amplitude, active_voice_mask);
 
-      poly_float distortion_swap = utils::swapVoices(voice_block_.distortion);
-      voice_block_.distortion = utils::maskLoad(distortion_swap, voice_block_.distortion, active_voice_mask);
-
-      poly_float last_distortion_swap = utils::swapVoices(voice_block_.last_distortion);
-      voice_block_.last_distortion = utils::maskLoad(last_distortion_swap, voice_block_.last_distortion,
-                                                     active_voice_mask);
-      poly_int swap_buffer_sample = utils::swapVoices(voice_block_.current_buffer_sample);
-      voice_block_.current_buffer_sample = utils::maskLoad(swap_buffer_sample, voice_block_.current_buffer_sample,
-                                                           active_voice_mask);
+      voice_block_.distortion = copyActiveVoice(voice_block_.distortion, active_voice_mask);
+      voice_block_.last_distortion = copyActiveVoice(voice_block_.last_distortion, active_voice_mask);
+      voice_block_.current_buffer_sample = copyActiveVoice(voice_block_.current_buffer_sample, active_voice_mask);
     }
 
-    int num_phase_updates = (poly_float::kSize - 1 + num_active_voices * active_oscillators_) / poly_float::kSize;
+    int num_phase_updates = (poly_float::kSize - 1 + num_lane_voices * active_oscillators_) / poly_float::kSize;
     for (int p = 1; p < num_phase_updates; ++p) {
-      loadVoiceBlock(voice_block_, p, active_voice_mask);
+      loadVoiceBlock(voice_block_, p, compact, active_voice_mask);
 
       poly_int phase = processDetuned<phaseDistort, window>(voice_block_, audio_out);
-      if (num_active_voices < 2)
-        expandAndWriteVoice(phases_ + 2 * p, phase, active_voice_mask);
+      if (compact)
+        expandAndWriteVoice(phases_ + kNumVoicesPerProcess * p, phase, active_voice_mask);
       else
         phases_[p] = phase;
     }
 
-    loadVoiceBlock(voice_block_, 0, active_voice_mask);
+    loadVoiceBlock(voice_block_, 0, compact, active_voice_mask);
 
     mono_float sample_inc = 1.0f / voice_block_.total_samples;
     poly_float delta_center_amplitude = (center_amplitude - current_center_amplitude) * sample_inc;
@@ -1498,7 +1573,7 @@ namespace vital {
                                                                 current_center_amplitude, delta_center_amplitude,
                                                                 current_detuned_amplitude, delta_detuned_amplitude);
 
-    if (num_active_voices < 2) {
+    if (compact) {
       expandAndWriteVoice(phases_, center_phase, active_voice_mask);
       convertVoiceChannels(num_samples, audio_out, active_voice_mask);
     }
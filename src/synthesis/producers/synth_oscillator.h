@@ -211,6 +211,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask, poly_int sample);
       void reset(poly_mask reset_mask) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void setSpectralMorphValues(SpectralMorph spectral_morph);
       void setDistortionValues(DistortionType distortion_type);
       void process(int num_samples) override;
@@ -236,7 +237,7 @@ namespace vital {
 
       void processBlend(int num_samples, poly_mask reset_mask);
 
-      void loadVoiceBlock(VoiceBlock& voice_block, int index, poly_mask active_mask);
+      void loadVoiceBlock(VoiceBlock& voice_block, int index, bool compact, poly_mask active_mask);
 
       void resetWavetableBuffers();
       void setActiveOscillators(int new_active_oscillators);
@@ -21,6 +21,7 @@
 #include "phaser_module.h"
 #include "decimator.h"
 #include "modulation_connection_processor.h"
+#include "processor_snapshot.h"
 #include "synth_constants.h"
 #include "synth_voice_handler.h"
 #include "peak_meter.h"
@@ -32,7 +33,9 @@ namespace vital {
 
   SoundEngine::SoundEngine() : SynthModule(0, 1), voice_handler_(nullptr), effect_chain_(nullptr),
                                output_total_(nullptr), last_oversampling_amount_(-1), last_sample_rate_(-1),
-                               oversampling_(nullptr), legato_(nullptr), decimator_(nullptr), peak_meter_(nullptr) {
+                               oversampling_override_(0), oversampling_(nullptr), legato_(nullptr),
+                               decimator_(nullptr), peak_meter_(nullptr),
+                               stems_enabled_(false), stem_decimators_(), stem_processors_(), stem_outputs_() {
     SoundEngine::init();
     bps_ = data_->controls["beats_per_minute"];
     modulation_processors_.reserve(kMaxModulationConnections);
@@ -131,7 +134,37 @@ namespace vital {
     addProcessor(clamp);
     clamp->useOutput(output());
 
+    for (int i = 0; i < kNumStems; ++i) {
+      Output* source = effect_chain_->output();
+      if (i <= kSampleStem)
+        source = voice_handler_->getStemOutput(i);
+      else if (i == kDryStem)
+        source = voice_handler_->output();
+
+      Decimator* stem_decimator = new Decimator(3);
+      stem_decimator->plug(source);
+      addProcessor(stem_decimator);
+
+      StereoEncoder* stem_decoder = new StereoEncoder(true);
+      stem_decoder->plug(stem_decimator, StereoEncoder::kAudio);
+      stem_decoder->plug(stereo_routing, StereoEncoder::kEncodingValue);
+      stem_decoder->plug(stereo_mode, StereoEncoder::kMode);
+      addProcessor(stem_decoder);
+
+      SmoothVolume* stem_volume = new SmoothVolume();
+      stem_volume->plug(stem_decoder, SmoothVolume::kAudioRate);
+      stem_volume->plug(volume, SmoothVolume::kDb);
+      addProcessor(stem_volume);
+
+      stem_decimators_[i] = stem_decimator;
+      stem_processors_[i][0] = stem_decimator;
+      stem_processors_[i][1] = stem_decoder;
+      stem_processors_[i][2] = stem_volume;
+      stem_outputs_[i] = stem_volume->output();
+    }
+
     SynthModule::init();
+    enableStems(false);
     disableUnnecessaryModSources();
     setOversamplingAmount(kDefaultOversamplingAmount, kDefaultSampleRate);
   }
@@ -217,7 +250,7 @@ namespace vital {
 
   void SoundEngine::checkOversampling() {
     int oversampling = oversampling_->value();
-    int oversampling_amount = 1 << oversampling;
+    int oversampling_amount = oversampling_override_ ? oversampling_override_ : 1 << oversampling;
     int sample_rate = getSampleRate();
     if (last_oversampling_amount_ != oversampling_amount || last_sample_rate_ != sample_rate)
       setOversamplingAmount(oversampling_amount, sample_rate);
@@ -258,6 +291,13 @@ namespace vital {
       status_source.second->update();
   }
 
+  void SoundEngine::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.require(last_oversampling_amount_);
+    snapshot.require(last_sample_rate_);
+    snapshot.require(stems_enabled_);
+    ProcessorRouter::copyState(snapshot);
+  }
+
   void SoundEngine::correctToTime(double seconds) {
     voice_handler_->correctToTime(seconds);
     effect_chain_->correctToTime(seconds);
@@ -267,6 +307,17 @@ namespace vital {
     voice_handler_->allSoundsOff();
     effect_chain_->hardReset();
     decimator_->hardReset();
+    for (Decimator* stem_decimator : stem_decimators_)
+      stem_decimator->hardReset();
+  }
+
+  void SoundEngine::enableStems(bool enable) {
+    stems_enabled_ = enable;
+    voice_handler_->enableStems(enable);
+    for (auto& stem : stem_processors_) {
+      for (Processor* processor : stem)
+        processor->enable(enable);
+    }
   }
 
   void SoundEngine::allNotesOff(int sample) {
@@ -281,6 +332,10 @@ namespace vital {
     voice_handler_->allNotesOffRange(sample, from_channel, to_channel);
   }
 
+  void SoundEngine::resetVoiceAllocation() {
+    voice_handler_->resetVoiceAllocation();
+  }
+
   void SoundEngine::noteOn(int note, mono_float velocity, int sample, int channel) {
     voice_handler_->noteOn(note, velocity, sample, channel);
   }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "circular_queue.h"
+#include "synth_constants.h"
 #include "synth_module.h"
 #include "note_handler.h"
 
@@ -38,6 +39,16 @@ namespace vital {
 
   class SoundEngine : public SynthModule, public NoteHandler {
     public:
+      // Separate outputs tapped from a single pass. Oscillator stems are
+      // 0 to kNumOscillators - 1. Dry is the effect chain's input, wet its
+      // output; the main output is wet plus anything routed to direct out.
+      enum Stem {
+        kSampleStem = kNumOscillators,
+        kDryStem,
+        kWetStem,
+        kNumStems
+      };
+
       static constexpr int kDefaultOversamplingAmount = 2;
       static constexpr int kDefaultSampleRate = 44100;
 
@@ -46,6 +57,7 @@ namespace vital {
 
       void init() override;
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
       void correctToTime(double seconds) override;
 
       int getNumPressedNotes();
@@ -61,6 +73,7 @@ namespace vital {
       void allNotesOff(int sample) override;
       void allNotesOff(int sample, int channel) override;
       void allNotesOffRange(int sample, int from_channel, int to_channel);
+      void resetVoiceAllocation();
 
       void noteOn(int note, mono_float velocity, int sample, int channel) override;
       void noteOff(int note, mono_float lift, int sample, int channel) override;
@@ -95,6 +108,19 @@ namespace vital {
       void sostenutoOffRange(int sample, int from_channel, int to_channel);
       force_inline int getOversamplingAmount() const { return last_oversampling_amount_; }
 
+      // Fixes the oversampling amount regardless of the oversampling control,
+      // or follows the control again when 0. Takes effect at the next
+      // checkOversampling.
+      void setOversamplingOverride(int oversampling_amount) { oversampling_override_ = oversampling_amount; }
+      int getOversamplingOverride() const { return oversampling_override_; }
+
+      // Stem outputs are stereo at the host sample rate, after stereo routing
+      // and volume like the main output but without its clamp. They cost
+      // nothing while disabled, which they are by default.
+      void enableStems(bool enable);
+      bool stemsEnabled() const { return stems_enabled_; }
+      Output* getStemOutput(int stem) { return stem_outputs_[stem]; }
+
       void checkOversampling();
 
     private:
@@ -106,12 +132,18 @@ namespace vital {
 
       int last_oversampling_amount_;
       int last_sample_rate_;
+      int oversampling_override_;
       Value* oversampling_;
       Value* bps_;
       Value* legato_;
       Decimator* decimator_;
       PeakMeter* peak_meter_;
 
+      bool stems_enabled_;
+      Decimator* stem_decimators_[kNumStems];
+      Processor* stem_processors_[kNumStems][3];
+      Output* stem_outputs_[kNumStems];
+
       CircularQueue<Processor*> modulation_processors_;
 
       JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoundEngine)
@@ -15,12 +15,18 @@
  */
 
 #include "legato_filter.h"
+#include "processor_snapshot.h"
 #include "utils.h"
 
 namespace vital {
 
   LegatoFilter::LegatoFilter() : Processor(kNumInputs, kNumOutputs, true), last_value_(kVoiceOff) { }
 
+  void LegatoFilter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(last_value_);
+    Processor::copyState(snapshot);
+  }
+
   void LegatoFilter::process(int num_samples) {
     output(kRetrigger)->clearTrigger();
 
@@ -40,6 +40,7 @@ namespace vital {
       }
 
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
     private:
       poly_float last_value_;
@@ -15,6 +15,7 @@
  */
 
 #include "peak_meter.h"
+#include "processor_snapshot.h"
 #include "utils.h"
 #include "synth_constants.h"
 
@@ -29,6 +30,11 @@ namespace vital {
   PeakMeter::PeakMeter() : Processor(1, 2), current_peak_(0.0f), current_square_sum_(0.0f),
                            remembered_peak_(0.0f), samples_since_remembered_(0) { }
 
+  void PeakMeter::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(current_peak_, current_square_sum_, remembered_peak_, samples_since_remembered_);
+    Processor::copyState(snapshot);
+  }
+
   void PeakMeter::process(int num_samples) {
     const poly_float* audio_in = input(0)->source->buffer;
     poly_float peak = utils::peak(audio_in, num_samples);
@@ -34,6 +34,7 @@ namespace vital {
 
       virtual Processor* clone() const override { return new PeakMeter(*this); }
       void process(int num_samples) override;
+      void copyState(ProcessorSnapshot& snapshot) override;
 
     protected:
       poly_float current_peak_;
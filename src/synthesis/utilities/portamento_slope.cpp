@@ -16,6 +16,7 @@
 
 #include "portamento_slope.h"
 
+#include "processor_snapshot.h"
 #include "utils.h"
 #include "futils.h"
 
@@ -27,6 +28,11 @@ namespace vital {
     output()->buffer[0] = input(kTarget)->source->buffer[0];
   }
 
+  void PortamentoSlope::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(position_);
+    Processor::copyState(snapshot);
+  }
+
   void PortamentoSlope::process(int num_samples) {
     bool force = input(kPortamentoForce)->at(0)[0];
     poly_float run_seconds = input(kRunSeconds)->at(0);
@@ -45,6 +45,7 @@ namespace vital {
 
       void processBypass(int start);
       virtual void process(int num_samples) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
     private:
       poly_float position_;
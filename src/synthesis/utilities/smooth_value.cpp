@@ -19,6 +19,7 @@
 #include <cmath>
 
 #include "futils.h"
+#include "processor_snapshot.h"
 
 namespace vital {
 
@@ -48,6 +49,11 @@ namespace vital {
     current_value_ = utils::maskLoad(current_value, current_value_, equal_mask);
   }
 
+  void SmoothValue::copyState(ProcessorSnapshot& snapshot) {
+    snapshot.copy(current_value_);
+    Value::copyState(snapshot);
+  }
+
   void SmoothValue::linearInterpolate(int num_samples, poly_mask linear_mask) {
     poly_float current_value = current_value_;
     current_value_ = utils::maskLoad(current_value_, value_, linear_mask);
@@ -72,5 +78,10 @@ namespace vital {
       current_value_ = utils::interpolate(value_, current_value_, decay);
       output()->buffer[0] = current_value_;
     }
+
+    void SmoothValue::copyState(ProcessorSnapshot& snapshot) {
+      snapshot.copy(current_value_);
+      Value::copyState(snapshot);
+    }
   } // namespace cr
 } // namespace vital
@@ -31,6 +31,7 @@ namespace vital {
       }
 
       virtual void process(int num_samples) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
       void linearInterpolate(int num_samples, poly_mask linear_mask);
 
       void set(poly_float value) override {
@@ -60,6 +61,7 @@ namespace vital {
         }
 
         virtual void process(int num_samples) override;
+        virtual void copyState(ProcessorSnapshot& snapshot) override;
 
         void setHard(mono_float value) {
           Value::set(value);
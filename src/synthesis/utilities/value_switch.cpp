@@ -16,6 +16,7 @@
 
 #include "value_switch.h"
 
+#include "processor_snapshot.h"
 #include "utils.h"
 
 namespace vital {
@@ -32,6 +33,12 @@ namespace vital {
     setSource(value[0]);
   }
 
+  void ValueSwitch::copyState(ProcessorSnapshot& snapshot) {
+    cr::Value::copyState(snapshot);
+    if (snapshot.mode() == ProcessorSnapshot::kRestoring)
+      setBuffer(value_[0]);
+  }
+
   void ValueSwitch::setOversampleAmount(int oversample) {
     cr::Value::setOversampleAmount(oversample);
     int num_inputs = numInputs();
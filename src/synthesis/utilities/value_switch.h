@@ -33,6 +33,7 @@ namespace vital {
       virtual Processor* clone() const override { return new ValueSwitch(*this); }
       virtual void process(int num_samples) override { }
       virtual void set(poly_float value) override;
+      virtual void copyState(ProcessorSnapshot& snapshot) override;
 
       void addProcessor(Processor* processor) { processors_.push_back(processor); }
 
@@ -27,6 +27,8 @@
 #include "load_save.cpp"
 #include "synth_types.cpp"
 #include "synth_base.cpp"
+#include "render_pool.cpp"
+#include "dataset_writer.cpp"
 #include "wavetable_component_factory.cpp"
 #include "wavetable_keyframe.cpp"
 #include "file_source.cpp"
@@ -39,6 +39,7 @@
 #include "feedback.cpp"
 #include "voice_handler.cpp"
 #include "processor.cpp"
+#include "processor_snapshot.cpp"
 #include "synth_module.cpp"
 #include "operators.cpp"
 #include "processor_router.cpp"
@@ -0,0 +1,119 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dispatch_benchmark.h"
+#include "synth_parameters.h"
+
+namespace {
+  constexpr int kBlockSize = 64;
+  constexpr int kWarmupBlocks = 1000;
+  constexpr int kTimedBlocks = 20000;
+  constexpr int kRuns = 2;
+  constexpr int kNumNotes = 4;
+  constexpr int kNumPadNotes = 16;
+  constexpr int kPadUnison = 8;
+
+  void turnAllModulesOn(vital::SoundEngine* engine) {
+    std::map<std::string, vital::ValueDetails> parameters = vital::Parameters::lookup_.getAllDetails();
+    vital::control_map controls = engine->getControls();
+    for (auto& parameter : parameters) {
+      String name = parameter.second.name;
+      if (name.endsWith("_on") && controls.count(parameter.second.name))
+        controls[parameter.second.name]->set(1.0f);
+    }
+  }
+} // namespace
+
+double DispatchBenchmark::microsecondsPerBlock(vital::SoundEngine& engine) {
+  for (int i = 0; i < kWarmupBlocks; ++i)
+    engine.process(kBlockSize);
+
+  double start = Time::getMillisecondCounterHiRes();
+  for (int i = 0; i < kTimedBlocks; ++i)
+    engine.process(kBlockSize);
+  double elapsed = Time::getMillisecondCounterHiRes() - start;
+
+  expect(vital::utils::isFinite(engine.output()->buffer, kBlockSize));
+  return 1000.0 * elapsed / kTimedBlocks;
+}
+
+void DispatchBenchmark::compareDispatch(vital::SoundEngine& engine, const String& description) {
+  // Alternate the two so drift in the machine's speed hits both alike.
+  double scheduled = std::numeric_limits<double>::max();
+  double walked = std::numeric_limits<double>::max();
+  for (int i = 0; i < kRuns; ++i) {
+    vital::ProcessorRouter::setSchedulesEnabled(false);
+    walked = std::min(walked, microsecondsPerBlock(engine));
+
+    vital::ProcessorRouter::setSchedulesEnabled(true);
+    int schedule_changes = engine.scheduleChanges();
+    scheduled = std::min(scheduled, microsecondsPerBlock(engine));
+    // Once settled, nothing is enabled or disabled from block to block, so
+    // the schedules are built once.
+    expectEquals(engine.scheduleChanges(), schedule_changes);
+  }
+
+  logMessage(description + ": " + String(scheduled, 3) + " us per " + String(kBlockSize) +
+             " sample block with schedules, " + String(walked, 3) + " us walking every processor (" +
+             String(100.0 * (walked - scheduled) / walked, 1) + "% saved)");
+}
+
+void DispatchBenchmark::idleGraph() {
+  beginTest("Idle Graph");
+
+  // No voices and the default controls, so nearly all the time goes to
+  // walking the graph rather than to DSP.
+  vital::SoundEngine engine;
+  compareDispatch(engine, "Default graph, no voices");
+}
+
+void DispatchBenchmark::fullGraph() {
+  beginTest("Full Graph");
+
+  vital::SoundEngine engine;
+  turnAllModulesOn(&engine);
+  for (int i = 0; i < kNumNotes; ++i)
+    engine.noteOn(48 + 7 * i, 1.0f, 0, 0);
+
+  compareDispatch(engine, "Every module on, " + String(kNumNotes) + " voices");
+}
+
+void DispatchBenchmark::bigPad() {
+  beginTest("Big Pad");
+
+  // Three oscillators with eight unison voices each on sixteen held notes,
+  // so nearly all the time goes to the oscillators.
+  vital::SoundEngine engine;
+  vital::control_map controls = engine.getControls();
+  controls["polyphony"]->set(kNumPadNotes);
+  for (int i = 1; i <= vital::kNumOscillators; ++i) {
+    std::string prefix = "osc_" + std::to_string(i);
+    controls[prefix + "_on"]->set(1.0f);
+    controls[prefix + "_unison_voices"]->set(kPadUnison);
+  }
+  for (int i = 0; i < kNumPadNotes; ++i)
+    engine.noteOn(36 + 3 * i, 1.0f, 0, 0);
+
+  compareDispatch(engine, String(kNumPadNotes) + " voices, " + String(kPadUnison) + " unison on every oscillator");
+}
+
+void DispatchBenchmark::runTest() {
+  idleGraph();
+  fullGraph();
+  bigPad();
+}
+
+static DispatchBenchmark dispatch_benchmark;
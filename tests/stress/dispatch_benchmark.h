@@ -0,0 +1,34 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+#include "sound_engine.h"
+
+class DispatchBenchmark : public UnitTest {
+  public:
+    DispatchBenchmark() : UnitTest("Processor Dispatch", "Stress") { }
+    void runTest() override;
+    void idleGraph();
+    void fullGraph();
+    void bigPad();
+    double microsecondsPerBlock(vital::SoundEngine& engine);
+    // Times engine with the routers' compiled schedules and with a plain walk
+    // of every processor, and logs both.
+    void compareDispatch(vital::SoundEngine& engine, const String& description);
+};
@@ -14,5 +14,6 @@
  * along with vital.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "stress/dispatch_benchmark.cpp"
 #include "stress/modulation_stress_test.cpp"
 #include "stress/engine_launch_test.cpp"
@@ -16,6 +16,7 @@
 
 #include "matrix_test.h"
 #include "matrix.h"
+#include "poly_utils.h"
 
 #define EPSILON 0.0000001f
 
@@ -43,6 +44,23 @@ void MatrixTest::runTest() {
   expect(matrix.row1[3] == 14.0f);
   expect(matrix.row2[3] == 15.0f);
   expect(matrix.row3[3] == 16.0f);
+
+  beginTest("Value Matrix");
+  vital::mono_float buffer[64];
+  for (int i = 0; i < 64; ++i)
+    buffer[i] = i;
+
+  vital::poly_int indices;
+  for (int i = 0; i < vital::poly_int::kSize; ++i)
+    indices.set(i, 7 * i + 3);
+
+  vital::matrix value_matrix = vital::utils::getValueMatrix(buffer, indices);
+  value_matrix.transpose();
+  vital::poly_float taps[] = { value_matrix.row0, value_matrix.row1, value_matrix.row2, value_matrix.row3 };
+  for (int t = 0; t < 4; ++t) {
+    for (int i = 0; i < vital::poly_float::kSize; ++i)
+      expect(taps[t][i] == buffer[indices[i] + t]);
+  }
 }
 
 static MatrixTest matrix_test;
@@ -22,6 +22,7 @@
 void PolyValuesTest::runTest() {
   runFloatTests();
   runIntTests();
+  runLaneTests();
 }
 
 void PolyValuesTest::runFloatTests() {
@@ -103,7 +104,7 @@ void PolyValuesTest::runFloatTests() {
 
   beginTest("Floats Sum");
   vital::poly_float to_sum(1.0f, -2.0f, 3.0f, -4.0f);
-  expect(to_sum.sum() == -2.0f);
+  expect(to_sum.sum() == -2.0f * (vital::poly_float::kSize / 4));
 }
 
 void PolyValuesTest::runIntTests() {
@@ -257,7 +258,7 @@ void PolyValuesTest::runIntTests() {
 
   beginTest("Ints Sum");
   vital::poly_int to_sum(1, -2, 3, -4);
-  expect(to_sum.sum() == (unsigned int)-2);
+  expect(to_sum.sum() == (unsigned int)(-2 * (int)(vital::poly_int::kSize / 4)));
 
   beginTest("Detect Mask");
   vital::poly_float compare(1.0f, -2.0f, 3.0f, -4.0f);
@@ -269,4 +270,116 @@ void PolyValuesTest::runIntTests() {
   expect(vital::poly_float::equal(compare, 5.0f).anyMask() == 0);
 }
 
+// Every lane checked against the scalar result, so wider values are held to
+// what each four lane value computes.
+void PolyValuesTest::runLaneTests() {
+  static constexpr int kSize = vital::poly_float::kSize;
+  // Fused multiply adds round once, so they only match to within rounding.
+  static constexpr float kFusedError = 0.00001f;
+
+  beginTest("Lanes Replicated Constructors");
+  vital::poly_float float_four(1.0f, 2.0f, 3.0f, 4.0f);
+  vital::poly_float float_two(5.0f, 6.0f);
+  vital::poly_int int_four(1, 2, 3, 4);
+  for (int i = 0; i < kSize; ++i) {
+    expect(float_four[i] == (i % 4) + 1.0f);
+    expect(float_two[i] == (i % 2) + 5.0f);
+    expect(int_four[i] == (i % 4) + 1);
+  }
+
+  vital::poly_float one;
+  vital::poly_float two;
+  vital::poly_float three;
+  vital::poly_int int_one;
+  vital::poly_int int_two;
+  for (int i = 0; i < kSize; ++i) {
+    one.set(i, i - 3.5f);
+    two.set(i, 2.0f * i + 1.0f);
+    three.set(i, 0.25f * i);
+    int_one.set(i, 3 * i - 10);
+    int_two.set(i, 7 - 2 * i);
+  }
+
+  beginTest("Lanes Float Arithmetic");
+  vital::poly_float add = one + two;
+  vital::poly_float subtract = one - two;
+  vital::poly_float multiply = one * two;
+  vital::poly_float divide = one / two;
+  vital::poly_float mul_add = vital::poly_float::mulAdd(one, two, three);
+  vital::poly_float mul_sub = vital::poly_float::mulSub(one, two, three);
+  vital::poly_float negate = -one;
+  for (int i = 0; i < kSize; ++i) {
+    expect(add[i] == one[i] + two[i]);
+    expect(subtract[i] == one[i] - two[i]);
+    expect(multiply[i] == one[i] * two[i]);
+    expectWithinAbsoluteError(divide[i], one[i] / two[i], EPSILON);
+    expectWithinAbsoluteError(mul_add[i], one[i] + two[i] * three[i], kFusedError);
+    expectWithinAbsoluteError(mul_sub[i], one[i] - two[i] * three[i], kFusedError);
+    expect(negate[i] == -one[i]);
+  }
+
+  beginTest("Lanes Float Compare");
+  vital::poly_float high = vital::poly_float::max(one, three);
+  vital::poly_float low = vital::poly_float::min(one, three);
+  vital::poly_mask greater = vital::poly_float::greaterThan(one, three);
+  vital::poly_mask less_equal = vital::poly_float::lessThanOrEqual(one, three);
+  vital::poly_mask equal = vital::poly_float::equal(one, one);
+  vital::poly_mask not_equal = vital::poly_float::notEqual(one, three);
+  for (int i = 0; i < kSize; ++i) {
+    expect(high[i] == std::max(one[i], three[i]));
+    expect(low[i] == std::min(one[i], three[i]));
+    expect(greater[i] == (one[i] > three[i] ? (unsigned int)-1 : 0));
+    expect(less_equal[i] == (one[i] <= three[i] ? (unsigned int)-1 : 0));
+    expect(equal[i] == (unsigned int)-1);
+    expect(not_equal[i] == (one[i] != three[i] ? (unsigned int)-1 : 0));
+  }
+
+  vital::poly_float last_lane = 0.0f;
+  last_lane.set(kSize - 1, 1.0f);
+  expect(vital::poly_float::equal(last_lane, 1.0f).anyMask() != 0);
+  expect(vital::poly_float::equal(last_lane, 2.0f).anyMask() == 0);
+
+  beginTest("Lanes Int Arithmetic");
+  vital::poly_int int_add = int_one + int_two;
+  vital::poly_int int_subtract = int_one - int_two;
+  vital::poly_int int_multiply = int_one * int_two;
+  vital::poly_int int_max = vital::poly_int::max(int_one, int_two);
+  vital::poly_int int_min = vital::poly_int::min(int_one, int_two);
+  vital::poly_mask int_greater = vital::poly_int::greaterThan(int_one, int_two);
+  for (int i = 0; i < kSize; ++i) {
+    int32_t a = int_one[i];
+    int32_t b = int_two[i];
+    expect(int_add[i] == (uint32_t)(a + b));
+    expect(int_subtract[i] == (uint32_t)(a - b));
+    expect(int_multiply[i] == (uint32_t)(a * b));
+    expect(int_max[i] == std::max(int_one[i], int_two[i]));
+    expect(int_min[i] == (uint32_t)std::min(a, b));
+    expect(int_greater[i] == (int_one[i] > int_two[i] ? (unsigned int)-1 : 0));
+  }
+
+  beginTest("Lanes Sum");
+  vital::mono_float float_total = 0.0f;
+  uint32_t int_total = 0;
+  for (int i = 0; i < kSize; ++i) {
+    float_total += two[i];
+    int_total += int_one[i];
+  }
+  expect(two.sum() == float_total);
+  expect(int_one.sum() == int_total);
+
+  beginTest("Lanes Transpose");
+  vital::poly_float rows[4];
+  for (int r = 0; r < 4; ++r) {
+    for (int i = 0; i < kSize; ++i)
+      rows[r].set(i, 100.0f * r + i);
+  }
+  vital::poly_float::transpose(rows[0].value, rows[1].value, rows[2].value, rows[3].value);
+  for (int r = 0; r < 4; ++r) {
+    for (int i = 0; i < kSize; ++i) {
+      int half = i - i % 4;
+      expect(rows[r][i] == 100.0f * (i % 4) + half + r);
+    }
+  }
+}
+
 static PolyValuesTest poly_values_test;
@@ -0,0 +1,71 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "processor_router_test.h"
+#include "operators.h"
+#include "processor_router.h"
+#include "value.h"
+
+void ProcessorRouterTest::runTest() {
+  testOwnedInputOrdering();
+  testBorrowedInputOrdering();
+}
+
+void ProcessorRouterTest::testOwnedInputOrdering() {
+  beginTest("Owned Input Ordering");
+  vital::cr::Value value(1.0f);
+  vital::ProcessorRouter router;
+
+  // Added ahead of its source, so plugging it in has to move it after.
+  vital::cr::Add* consumer = new vital::cr::Add();
+  consumer->plug(&value, 1);
+  router.addProcessor(consumer);
+
+  vital::cr::Add* source = new vital::cr::Add();
+  source->plug(&value, 0);
+  source->plug(&value, 1);
+  router.addProcessor(source);
+
+  consumer->plug(source, 0);
+  expect(router.isDownstream(source, consumer));
+  expect(router.areOrdered(source, consumer));
+}
+
+void ProcessorRouterTest::testBorrowedInputOrdering() {
+  beginTest("Borrowed Input Ordering");
+  vital::cr::Value value(1.0f);
+  vital::ProcessorRouter router;
+
+  // Reads its first input through another processor's input, the way a
+  // module's children read the module's inputs.
+  vital::cr::Add lender;
+  vital::cr::Add* consumer = new vital::cr::Add();
+  consumer->useInput(lender.input(0), 0);
+  consumer->plug(&value, 1);
+  router.addProcessor(consumer);
+
+  vital::cr::Add* source = new vital::cr::Add();
+  source->plug(&value, 0);
+  source->plug(&value, 1);
+  router.addProcessor(source);
+
+  consumer->plug(source, 0);
+  expect(lender.input(0)->source == source->output());
+  expect(router.isDownstream(source, consumer));
+  expect(router.areOrdered(source, consumer));
+}
+
+static ProcessorRouterTest processor_router_test;
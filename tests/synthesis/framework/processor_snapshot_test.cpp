@@ -0,0 +1,127 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "processor_snapshot_test.h"
+#include "processor_snapshot.h"
+#include "sound_engine.h"
+#include "synth_parameters.h"
+
+namespace {
+  constexpr int kBlockSize = 64;
+  constexpr int kSettleBlocks = 50;
+  constexpr int kRenderBlocks = 100;
+
+  void turnAllModulesOn(vital::SoundEngine* engine) {
+    std::map<std::string, vital::ValueDetails> parameters = vital::Parameters::lookup_.getAllDetails();
+    vital::control_map controls = engine->getControls();
+    for (auto& parameter : parameters) {
+      String name = parameter.second.name;
+      if (name.endsWith("_on") && controls.count(parameter.second.name))
+        controls[parameter.second.name]->set(1.0f);
+    }
+  }
+
+  void startEngine(vital::SoundEngine* engine) {
+    engine->setSampleRate(vital::kDefaultSampleRate);
+    turnAllModulesOn(engine);
+    vital::control_map controls = engine->getControls();
+    controls["osc_1_unison_voices"]->set(5.0f);
+    controls["osc_1_spectral_morph_type"]->set(3.0f);
+    controls["osc_1_spectral_morph_amount"]->set(0.5f);
+    controls["filter_1_model"]->set(2.0f);
+
+    engine->noteOn(60, 0.8f, 0, 0);
+    engine->noteOn(64, 0.7f, 0, 0);
+    for (int i = 0; i < kSettleBlocks; ++i)
+      engine->process(kBlockSize);
+    engine->noteOff(60, 0.5f, 0, 0);
+  }
+
+  // Plays a note over the held one and records the output.
+  std::vector<vital::poly_float> render(vital::SoundEngine* engine) {
+    std::vector<vital::poly_float> output;
+    engine->noteOn(67, 0.9f, 0, 0);
+    for (int i = 0; i < kRenderBlocks; ++i) {
+      if (i == kRenderBlocks / 2)
+        engine->noteOff(67, 0.5f, 0, 0);
+      engine->process(kBlockSize);
+      output.insert(output.end(), engine->output()->buffer, engine->output()->buffer + kBlockSize);
+    }
+    return output;
+  }
+
+  bool equal(const std::vector<vital::poly_float>& one, const std::vector<vital::poly_float>& two) {
+    if (one.size() != two.size())
+      return false;
+    for (size_t i = 0; i < one.size(); ++i) {
+      if (vital::poly_float::notEqual(one[i], two[i]).anyMask())
+        return false;
+    }
+    return true;
+  }
+} // namespace
+
+void ProcessorSnapshotTest::runTest() {
+  testRestoreRepeatsRender();
+  testRestoreRevertsControls();
+  testRestoreOnOtherEngine();
+}
+
+void ProcessorSnapshotTest::testRestoreRepeatsRender() {
+  beginTest("Restore Repeats Render");
+  vital::SoundEngine engine;
+  startEngine(&engine);
+
+  vital::ProcessorSnapshot snapshot;
+  snapshot.save(&engine);
+  expect(!snapshot.empty());
+  std::vector<vital::poly_float> first = render(&engine);
+
+  expect(snapshot.restore(&engine));
+  std::vector<vital::poly_float> second = render(&engine);
+  expect(equal(first, second));
+}
+
+void ProcessorSnapshotTest::testRestoreRevertsControls() {
+  beginTest("Restore Reverts Controls");
+  vital::SoundEngine engine;
+  startEngine(&engine);
+
+  vital::ProcessorSnapshot snapshot;
+  snapshot.save(&engine);
+  std::vector<vital::poly_float> first = render(&engine);
+
+  vital::Value* level = engine.getControls()["osc_1_level"];
+  vital::mono_float saved_level = level->value();
+  level->set(0.1f);
+  expect(snapshot.restore(&engine));
+  expectEquals(level->value(), saved_level);
+  expect(equal(first, render(&engine)));
+}
+
+void ProcessorSnapshotTest::testRestoreOnOtherEngine() {
+  beginTest("Restore On Other Engine");
+  vital::SoundEngine engine;
+  startEngine(&engine);
+  vital::ProcessorSnapshot snapshot;
+  snapshot.save(&engine);
+
+  vital::SoundEngine other;
+  startEngine(&other);
+  expect(!snapshot.restore(&other));
+}
+
+static ProcessorSnapshotTest processor_snapshot_test;
@@ -35,15 +35,48 @@ void PolyUtilsTest::runTest() {
 
   beginTest("Swap Voices");
   vital::poly_float swap_voices = vital::utils::swapVoices(test_value);
-  for (int i = 0; i < vital::poly_float::kSize / 2; ++i) {
-    expect(swap_voices[i] == i + vital::poly_float::kSize / 2);
-    expect(swap_voices[i + vital::poly_float::kSize / 2] == i);
+  for (int i = 0; i < vital::poly_float::kSize; i += 4) {
+    expect(swap_voices[i] == i + 2);
+    expect(swap_voices[i + 1] == i + 3);
+    expect(swap_voices[i + 2] == i);
+    expect(swap_voices[i + 3] == i + 1);
   }
 
+  beginTest("Swap Halves");
+  vital::poly_float swap_halves = vital::utils::swapHalves(test_value);
+  for (int i = 0; i < vital::poly_float::kSize; ++i)
+    expect(swap_halves[i] == (i + 4) % vital::poly_float::kSize);
+
+  beginTest("Sum Voices");
+  vital::poly_float sum_voices = vital::utils::sumVoices(test_value);
+  vital::mono_float left_total = 0.0f;
+  vital::mono_float right_total = 0.0f;
+  for (int i = 0; i < vital::poly_float::kSize; i += 2) {
+    left_total += i;
+    right_total += i + 1;
+  }
+  for (int i = 0; i < vital::poly_float::kSize; i += 2) {
+    expect(sum_voices[i] == left_total);
+    expect(sum_voices[i + 1] == right_total);
+  }
+
+  beginTest("Copy First Voice");
+  vital::poly_float first_voice = vital::utils::copyFirstVoice(test_value);
+  for (int i = 0; i < vital::poly_float::kSize; i += 2) {
+    expect(first_voice[i] == 0.0f);
+    expect(first_voice[i + 1] == 1.0f);
+  }
+
+  beginTest("Max Min Float");
+  expect(vital::utils::maxFloat(test_value) == vital::poly_float::kSize - 1);
+  expect(vital::utils::minFloat(test_value) == 0.0f);
+
   beginTest("Reverse");
   vital::poly_float reverse = vital::utils::reverse(test_value);
-  for (int i = 0; i < vital::poly_float::kSize; ++i)
-    expect(reverse[i] == vital::poly_float::kSize - 1 - i);
+  for (int i = 0; i < vital::poly_float::kSize; i += 4) {
+    for (int j = 0; j < 4; ++j)
+      expect(reverse[i + j] == i + 3 - j);
+  }
 
   beginTest("Mid Side Encoding");
   vital::poly_float encode_mid_side = vital::utils::encodeMidSide(test_value);
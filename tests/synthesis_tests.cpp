@@ -20,6 +20,8 @@
 #include "synthesis/framework/circular_queue_test.cpp"
 #include "synthesis/framework/matrix_test.cpp"
 #include "synthesis/framework/poly_values_test.cpp"
+#include "synthesis/framework/processor_router_test.cpp"
+#include "synthesis/framework/processor_snapshot_test.cpp"
 #include "synthesis/lookups/wave_frame_test.cpp"
 #include "synthesis/producers/synth_oscillator_test.cpp"
 #include "synthesis/producers/sample_source_test.cpp"
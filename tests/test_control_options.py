@@ -7,10 +7,13 @@ which has crashed the interpreter and, worse, silently returned names belonging
 to an unrelated array.
 """
 
+import json
+
 import numpy as np
 import pytest
 
 import vita
+from vita.constants import ValueScale
 
 
 @pytest.fixture(scope="module")
@@ -163,3 +166,71 @@ def test_render_still_works_after_metadata_reads(synth):
     audio = synth.render(60, 0.7, 0.2, 0.5)
     assert audio.shape[0] == 2
     assert np.isfinite(audio).all()
+
+
+def test_control_ids():
+    synth = vita.Synth()
+    controls = synth.get_controls()
+    ids = {name: synth.control_id(name) for name in controls}
+    assert len(set(ids.values())) == len(ids)
+    assert vita.Synth().control_id("filter_1_cutoff") == ids["filter_1_cutoff"]
+
+    cutoff = ids["filter_1_cutoff"]
+    synth.set_by_id(cutoff, 42.0)
+    assert synth.get_by_id(cutoff) == 42.0
+    assert controls["filter_1_cutoff"].value() == 42.0
+
+    controls["filter_1_cutoff"].set(64.0)
+    assert synth.get_by_id(cutoff) == 64.0
+
+    with pytest.raises(ValueError):
+        synth.control_id("no_such_control")
+    with pytest.raises(IndexError):
+        synth.set_by_id(-1, 0.0)
+    with pytest.raises(IndexError):
+        synth.get_by_id(max(ids.values()) + 1000)
+
+
+def test_randomize_is_seeded():
+    first, second = vita.Synth(), vita.Synth()
+    first.randomize(1234)
+    second.randomize(1234)
+    values = first.get_parameter_vector(normalized=False)
+    assert np.array_equal(values, second.get_parameter_vector(normalized=False))
+
+    second.randomize(1235)
+    assert not np.array_equal(values, second.get_parameter_vector(normalized=False))
+
+
+def test_randomize_respects_ranges_and_filters():
+    synth = vita.Synth()
+    before = {name: c.value() for name, c in synth.get_controls().items()}
+    synth.randomize(7, include=["filter_1_*", "delay_style"], exclude=["filter_1_on"],
+                    distribution="uniform")
+
+    changed = {name for name, c in synth.get_controls().items() if c.value() != before[name]}
+    assert changed
+    assert all(name.startswith("filter_1_") or name == "delay_style" for name in changed)
+    assert "filter_1_on" not in changed
+
+    for name in ("filter_1_model", "filter_1_style", "delay_style"):
+        info = synth.get_control_details(name)
+        value = synth.get_controls()[name].value()
+        assert info.min <= value <= info.max
+        if info.scale == ValueScale.Indexed:
+            assert value == int(value)
+
+    synth.randomize(7, include=["osc_1_level"], modulations=5)
+    modulations = json.loads(synth.to_json())["settings"]["modulations"]
+    connected = [m for m in modulations if m["source"]]
+    assert 0 < len(connected) <= 5
+    sources = set(vita.get_modulation_sources())
+    destinations = set(vita.get_modulation_destinations())
+    for modulation in connected:
+        assert modulation["source"] in sources
+        assert modulation["destination"] in destinations
+
+    with pytest.raises(ValueError):
+        synth.randomize(0, include=["no_such_control*"])
+    with pytest.raises(ValueError):
+        synth.randomize(0, distribution="gaussian")
@@ -0,0 +1,84 @@
+"""Tests for vita.DatasetWriter, which renders into a memory-mapped .npy file."""
+
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import pytest
+
+import vita
+
+SAMPLE_RATE = 44100
+NOTE_DUR = 0.2
+SAMPLES = 22050
+
+
+def _synth():
+    synth = vita.Synth()
+    synth.set_sample_rate(SAMPLE_RATE)
+    return synth
+
+
+@pytest.mark.parametrize("dtype", ["float32", "int16", "float16"])
+def test_writer_renders_in_place(tmp_path, dtype):
+    path = tmp_path / "data.npy"
+    with vita.DatasetWriter(str(path), 6, SAMPLES, dtype) as writer:
+        assert (writer.num_items, writer.samples, writer.dtype) == (6, SAMPLES, dtype)
+        assert writer.num_done == 0
+        writer.render(_synth(), 1, 60, 0.7, NOTE_DUR)
+        writer.render_batch(_synth(), 3, [48, 55, 72], [0.7], [NOTE_DUR])
+        assert writer.pending() == [0, 2]
+        assert writer.is_done(1) and not writer.is_done(2)
+
+    data = np.load(path, mmap_mode="r")
+    assert data.shape == (6, 2, SAMPLES)
+    assert data.dtype == np.dtype(dtype)
+    for index in [1, 3, 4, 5]:
+        assert np.abs(data[index].astype(np.float32)).max() > 0
+    for index in [0, 2]:
+        assert not data[index].any()
+
+
+def test_writer_threads_and_resume(tmp_path):
+    path = str(tmp_path / "data.npy")
+    writer = vita.DatasetWriter(path, 8, SAMPLES)
+    synths = [_synth() for _ in range(4)]
+
+    # Half the items from four threads, then stop.
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        list(pool.map(lambda i: writer.render(synths[i % 4], i, 48 + i, 0.7, NOTE_DUR), range(4)))
+    writer.close()
+    with pytest.raises(RuntimeError):
+        writer.render(synths[0], 4, 60, 0.7, NOTE_DUR)
+
+    resumed = vita.DatasetWriter(path, 8, SAMPLES)
+    assert resumed.num_done == 4
+    assert resumed.pending() == [4, 5, 6, 7]
+    for index in resumed.pending():
+        resumed.render(synths[0], index, 48 + index, 0.7, NOTE_DUR)
+    assert resumed.num_done == 8
+    resumed.close()
+
+    data = np.load(path)
+    assert all(np.abs(item).max() > 0 for item in data)
+
+
+def test_writer_errors(tmp_path):
+    path = str(tmp_path / "data.npy")
+    with pytest.raises(ValueError):
+        vita.DatasetWriter(path, 0, SAMPLES)
+    with pytest.raises(ValueError):
+        vita.DatasetWriter(path, 4, SAMPLES, "int32")
+
+    writer = vita.DatasetWriter(path, 4, SAMPLES)
+    with pytest.raises(IndexError):
+        writer.render(_synth(), 4, 60, 0.7, NOTE_DUR)
+    with pytest.raises(IndexError):
+        writer.render_batch(_synth(), 2, [60, 62, 64], [0.7], [NOTE_DUR])
+    writer.close()
+
+    # A different shape does not silently clobber the existing file.
+    with pytest.raises(ValueError):
+        vita.DatasetWriter(path, 5, SAMPLES)
+    replaced = vita.DatasetWriter(path, 5, SAMPLES, overwrite=True)
+    assert replaced.num_done == 0
+    replaced.close()
@@ -1,3 +1,4 @@
+import numpy as np
 import pytest
 import vita
 from vita.constants import ValueScale
@@ -142,3 +143,39 @@ if __name__ == "__main__":
     print("✓ Clipping test passed")
     
     print("\nAll normalized parameter tests passed!")
+
+
+def test_parameter_vector_matches_controls():
+    synth = vita.Synth()
+    names = vita.parameter_names()
+    controls = synth.get_controls()
+    assert len(names) == len(set(names))
+    assert set(controls) <= set(names)
+    for name in ("filter_1_cutoff", "delay_style", "env_1_attack"):
+        assert names.index(name) == synth.control_id(name)
+
+    rng = np.random.default_rng(0)
+    positions = rng.random(len(names), dtype=np.float32)
+    synth.set_parameter_vector(positions)
+
+    reference = vita.Synth()
+    reference_controls = reference.get_controls()
+    for i, name in enumerate(names):
+        if name in reference_controls:
+            reference_controls[name].set_normalized(float(positions[i]))
+    for name, control in controls.items():
+        assert control.value() == pytest.approx(reference_controls[name].value(), rel=1e-5, abs=1e-5), name
+
+    normalized = synth.get_parameter_vector()
+    plain = synth.get_parameter_vector(normalized=False)
+    assert normalized.dtype == np.float32 and normalized.shape == (len(names),)
+    for name, control in controls.items():
+        i = names.index(name)
+        assert plain[i] == control.value()
+        assert normalized[i] == pytest.approx(control.get_normalized(), abs=1e-6), name
+
+    synth.set_parameter_vector(plain, normalized=False)
+    assert np.array_equal(synth.get_parameter_vector(normalized=False), plain)
+
+    with pytest.raises(ValueError):
+        synth.set_parameter_vector(plain[:-1])
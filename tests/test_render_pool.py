@@ -0,0 +1,131 @@
+"""Tests for vita.RenderPool and Synth.render_async, which render on C++ worker threads."""
+
+import asyncio
+import os
+import threading
+
+import numpy as np
+import pytest
+
+import vita
+
+SAMPLE_RATE = 44100
+NOTE_DUR = 0.2
+RENDER_DUR = 0.5
+
+
+@pytest.fixture
+def preset_json():
+    synth = vita.Synth()
+    synth.get_controls()["osc_1_transpose"].set(7.0)
+    return synth.to_json()
+
+
+def test_pool_renders_jobs(preset_json):
+    num_samples = int(SAMPLE_RATE * RENDER_DUR)
+    with vita.RenderPool(num_threads=3, sample_rate=SAMPLE_RATE) as pool:
+        assert pool.num_threads == 3
+        futures = [pool.submit(preset_json, [48, 60], 0.7, NOTE_DUR, RENDER_DUR) for _ in range(6)]
+        results = [future.result() for future in futures]
+
+    for future, audio in zip(futures, results):
+        assert future.done()
+        assert audio.shape == (2, 2, num_samples)
+        assert audio.dtype == np.float32
+        assert np.isfinite(audio).all()
+        assert np.abs(audio).max() > 0.0
+        # Results are cached, so a second call returns the same array.
+        assert future.result() is audio
+
+
+def test_pool_callback(preset_json):
+    finished = []
+    lock = threading.Lock()
+
+    def on_done(future):
+        with lock:
+            finished.append(future.result().shape)
+
+    with vita.RenderPool(num_threads=2) as pool:
+        futures = [pool.submit(preset_json, [60], 0.7, NOTE_DUR, RENDER_DUR, callback=on_done) for _ in range(4)]
+        for future in futures:
+            future.result(timeout=60.0)
+
+    assert len(finished) == 4
+
+
+def test_pool_errors(preset_json, tmp_path):
+    with pytest.raises(ValueError):
+        vita.RenderPool(num_threads=0)
+
+    pool = vita.RenderPool(num_threads=1)
+    with pytest.raises(ValueError):
+        pool.submit(preset_json, [], 0.7, NOTE_DUR, RENDER_DUR)
+
+    missing = pool.submit(str(tmp_path / "missing.vital"), [60], 0.7, NOTE_DUR, RENDER_DUR)
+    with pytest.raises(RuntimeError):
+        missing.result()
+
+    # A failed load does not stop the worker rendering the next job.
+    assert pool.submit(preset_json, [60], 0.7, NOTE_DUR, RENDER_DUR).result().shape[0] == 1
+
+    pool.close()
+    with pytest.raises(RuntimeError):
+        pool.submit(preset_json, [60], 0.7, NOTE_DUR, RENDER_DUR)
+
+
+def test_pool_reloads_rewritten_preset(preset_json, tmp_path):
+    path = tmp_path / "preset.vital"
+    synth = vita.Synth()
+    path.write_text(synth.to_json())
+
+    with vita.RenderPool(num_threads=1, sample_rate=SAMPLE_RATE) as pool:
+        before = pool.submit(str(path), [60], 0.7, NOTE_DUR, RENDER_DUR).result()
+        # Same path, new contents: the worker must not render the stale preset.
+        # Both presets serialise to the same size, so only the modification
+        # time tells them apart; move it on in case the filesystem's clock is
+        # coarser than the render.
+        mtime = path.stat().st_mtime
+        path.write_text(preset_json)
+        os.utime(path, (mtime + 2.0, mtime + 2.0))
+        after = pool.submit(str(path), [60], 0.7, NOTE_DUR, RENDER_DUR).result()
+        from_json = pool.submit(preset_json, [60], 0.7, NOTE_DUR, RENDER_DUR).result()
+
+    assert not np.array_equal(before, after)
+    np.testing.assert_array_equal(after, from_json)
+
+
+def test_render_async():
+    num_samples = int(SAMPLE_RATE * RENDER_DUR)
+    synths = [vita.Synth() for _ in range(3)]
+    for synth in synths:
+        synth.set_sample_rate(SAMPLE_RATE)
+
+    async def render_all():
+        # Several renders per synth, all in flight at once.
+        futures = [synth.render_async(60, 0.7, NOTE_DUR, RENDER_DUR) for synth in synths for _ in range(4)]
+        return await asyncio.gather(*futures)
+
+    results = asyncio.run(render_all())
+    assert len(results) == 12
+    for audio in results:
+        assert audio.shape == (2, num_samples)
+        assert audio.dtype == np.float32
+        assert np.isfinite(audio).all()
+        assert np.abs(audio).max() > 0.0
+
+    # Without a running loop there is nothing to complete the future on.
+    with pytest.raises(RuntimeError):
+        synths[0].render_async(60, 0.7, NOTE_DUR, RENDER_DUR)
+
+
+def test_render_async_cancel():
+    synth = vita.Synth()
+
+    async def cancel_then_render():
+        cancelled = synth.render_async(60, 0.7, NOTE_DUR, RENDER_DUR)
+        cancelled.cancel()
+        # The cancelled render still runs, and the synth stays usable.
+        return await synth.render_async(60, 0.7, NOTE_DUR, RENDER_DUR)
+
+    assert asyncio.run(cancel_then_render()).shape[0] == 2
@@ -0,0 +1,157 @@
+"""Tests for copying and pickling a Synth's state."""
+
+import base64
+import copy
+import json
+import pickle
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import pytest
+
+import vita
+
+
+def _customized_synth() -> vita.Synth:
+    """Return a Synth whose state differs from the init preset in every part clone copies."""
+    synth = vita.Synth()
+    synth.set_sample_rate(48000)
+    assert synth.connect_modulation("lfo_1", "filter_1_cutoff")
+    controls = synth.get_controls()
+    controls["modulation_1_amount"].set(0.8)
+    controls["filter_1_on"].set(1.0)
+    controls["osc_2_on"].set(1.0)
+    controls["osc_1_transpose"].set(7.0)
+    return synth
+
+
+def _heavy_wavetable_synth() -> vita.Synth:
+    """Return a Synth whose three wavetables each hold 64 distinct keyframes."""
+    synth = _customized_synth()
+    preset = json.loads(synth.to_json())
+    phase = np.arange(2048) * (2.0 * np.pi / 2048)
+    for table, wavetable in enumerate(preset["settings"]["wavetables"]):
+        keyframes = []
+        for index in range(64):
+            wave = np.sin(phase * (1 + index % 16) + table) * (0.5 + index / 128.0)
+            keyframes.append({
+                "position": index * 4,
+                "wave_data": base64.b64encode(wave.astype("<f4").tobytes()).decode(),
+            })
+        wavetable["groups"][0]["components"][0]["keyframes"] = keyframes
+    synth.load_json(json.dumps(preset))
+    return synth
+
+
+def test_clone_matches_source():
+    synth = _customized_synth()
+    # Random phases would make every render differ.
+    for osc in ("osc_1", "osc_2", "osc_3"):
+        synth.get_controls()[f"{osc}_random_phase"].set(0.0)
+    clone = synth.clone()
+
+    assert json.loads(clone.to_json()) == json.loads(synth.to_json())
+    controls = synth.get_controls()
+    for name, value in clone.get_controls().items():
+        assert value.value() == controls[name].value(), name
+
+    audio = clone.render(60, 0.7, 0.2, 0.5)
+    assert audio.shape == (2, 24000)
+    assert np.abs(audio).max() > 0.0
+    assert np.array_equal(synth.render(60, 0.7, 0.2, 0.5), audio)
+
+
+def test_clone_is_independent():
+    synth = _customized_synth()
+    clone = copy.deepcopy(synth)
+
+    clone.get_controls()["osc_1_transpose"].set(-12.0)
+    clone.disconnect_modulation("lfo_1", "filter_1_cutoff")
+    assert synth.get_controls()["osc_1_transpose"].value() == 7.0
+    modulations = json.loads(synth.to_json())["settings"]["modulations"]
+    assert modulations[0]["source"] == "lfo_1"
+
+    del synth
+    assert np.abs(clone.render(60, 0.7, 0.2, 0.5)).max() > 0.0
+
+
+def test_clones_render_in_parallel():
+    synth = _customized_synth()
+    clones = [synth.clone() for _ in range(8)]
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        results = list(pool.map(lambda s: s.render(60, 0.7, 0.2, 0.5), clones))
+
+    for audio in results:
+        assert audio.shape == (2, 24000)
+        assert np.isfinite(audio).all()
+        assert np.abs(audio).max() > 0.0
+
+
+def test_pickle_round_trip_is_exact():
+    synth = _customized_synth()
+    state = synth.__getstate__()
+    assert isinstance(state, bytes)
+    assert state[:4] == b"VTSB"
+
+    restored = pickle.loads(pickle.dumps(synth))
+    assert json.loads(restored.to_json()) == json.loads(synth.to_json())
+    controls = synth.get_controls()
+    for name, value in restored.get_controls().items():
+        assert value.value() == controls[name].value(), name
+    assert restored.__getstate__() == state
+
+
+def test_pickle_restores_sample_rate_and_sound():
+    synth = _customized_synth()
+    for osc in ("osc_1", "osc_2", "osc_3"):
+        synth.get_controls()[f"{osc}_random_phase"].set(0.0)
+
+    restored = pickle.loads(pickle.dumps(synth))
+    audio = restored.render(60, 0.7, 0.2, 0.5)
+    # Half a second at the source's 48 kHz, not the default rate.
+    assert audio.shape == (2, 24000)
+    assert np.array_equal(synth.render(60, 0.7, 0.2, 0.5), audio)
+
+
+def test_pickle_is_smaller_than_json():
+    synth = _customized_synth()
+    # A new Synth's noise sample is float data; after a preset load it is
+    # 16-bit like any other preset's.
+    synth.load_json(synth.to_json())
+    # About 1.47 with the default wavetables and noise sample.
+    assert len(synth.to_json().encode()) >= 1.4 * len(synth.__getstate__())
+
+
+def test_pickle_of_heavy_wavetables_is_smaller_than_json():
+    # examples/state_benchmark.py times saving and loading this synth.
+    synth = _heavy_wavetable_synth()
+    preset = synth.to_json()
+    state = synth.__getstate__()
+    # About 1.35: keyframes are raw floats instead of base64.
+    assert len(preset.encode()) >= 1.3 * len(state)
+
+    restored = pickle.loads(pickle.dumps(synth))
+    assert restored.__getstate__() == state
+    assert json.loads(restored.to_json()) == json.loads(preset)
+
+
+def test_setstate_accepts_old_json_pickles():
+    synth = _customized_synth()
+    restored = vita.Synth.__new__(vita.Synth)
+    restored.__setstate__(synth.to_json())
+    assert json.loads(restored.to_json()) == json.loads(synth.to_json())
+
+
+def test_setstate_rejects_garbage():
+    restored = vita.Synth.__new__(vita.Synth)
+    with pytest.raises(ValueError):
+        restored.__setstate__(b"not a synth state")
+    with pytest.raises(ValueError):
+        restored.__setstate__("not a synth preset")
+
+    # A failed load destroys the synth it built, so the object can still be
+    # set up afterwards.
+    synth = _customized_synth()
+    restored.__setstate__(synth.__getstate__())
+    assert restored.__getstate__() == synth.__getstate__()
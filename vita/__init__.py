@@ -1,9 +1,14 @@
-from .vita import Synth, constants, get_modulation_sources, get_modulation_destinations
+from .vita import Synth, RenderPool, RenderFuture, DatasetWriter, constants, get_modulation_sources, get_modulation_destinations, parameter_names, simd_backend
 from .version import __version__
 
 __ALL__ = [
     "Synth",
+    "RenderPool",
+    "RenderFuture",
+    "DatasetWriter",
     "constants",
     "get_modulation_sources",
     "get_modulation_destinations",
+    "parameter_names",
+    "simd_backend",
 ]